@@ -0,0 +1,141 @@
+#include "WriteFields.H"
+
+#include <fstream>
+
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_Utility.H>
+
+#include "Util/Util.H"
+
+namespace IO
+{
+
+void WriteFields(const std::string &plotfilename, int nlevels,
+		 const amrex::Vector<amrex::Vector<const amrex::MultiFab*>> &fields,
+		 const amrex::Vector<std::string> &varnames,
+		 const amrex::Vector<amrex::Geometry> &geom,
+		 Set::Scalar time,
+		 const amrex::Vector<int> &iter,
+		 const amrex::Vector<amrex::IntVect> &ref_ratio)
+{
+	BL_PROFILE("IO::WriteFields");
+
+	const int ncomp = varnames.size();
+	const int myproc = amrex::ParallelDescriptor::MyProc();
+	const int ioproc = amrex::ParallelDescriptor::IOProcessorNumber();
+
+	amrex::Vector<amrex::BoxArray> boxarrays(nlevels);
+	for (int lev = 0; lev < nlevels; lev++)
+	{
+		if (fields[lev].size() == 0) Util::Abort(INFO,"No fields to write on level ",lev);
+		boxarrays[lev] = fields[lev][0]->boxArray();
+		int n = 0;
+		for (const amrex::MultiFab *mf : fields[lev]) n += mf->nComp();
+		if (n != ncomp) Util::Abort(INFO,"Level ",lev," has ",n," components but ",ncomp," names were given");
+	}
+
+	amrex::PreBuildDirectorHierarchy(plotfilename, "Level_", nlevels, true);
+
+	//
+	// Plotfile header - identical to the one written by amrex::WriteMultiLevelPlotfile
+	//
+	if (amrex::ParallelDescriptor::IOProcessor())
+	{
+		std::ofstream headerfile(plotfilename + "/Header", std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+		if (!headerfile.good()) Util::Abort(INFO,"Could not open ",plotfilename,"/Header");
+		amrex::WriteGenericPlotfileHeader(headerfile, nlevels, boxarrays, varnames, geom, time, iter, ref_ratio);
+	}
+
+	for (int lev = 0; lev < nlevels; lev++)
+	{
+		const amrex::BoxArray &ba = boxarrays[lev];
+		const amrex::DistributionMapping &dm = fields[lev][0]->DistributionMap();
+		const std::string fullprefix = amrex::MultiFabFileFullPrefix(lev, plotfilename, "Level_", "Cell");
+
+		std::vector<long> offset(ba.size(), 0);
+		std::vector<Set::Scalar> min(ba.size()*ncomp, 0.0), max(ba.size()*ncomp, 0.0);
+
+		//
+		// Each rank streams its own boxes to its own data file. Only one
+		// box worth of scratch space is ever allocated.
+		//
+		{
+			std::ofstream datafile;
+			amrex::FArrayBox fab;
+			for (amrex::MFIter mfi(*fields[lev][0]); mfi.isValid(); ++mfi)
+			{
+				if (!datafile.is_open())
+				{
+					datafile.open(fullprefix + amrex::Concatenate("_D_", myproc, 5), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+					if (!datafile.good()) Util::Abort(INFO,"Could not open data file for level ",lev);
+				}
+
+				const amrex::Box &bx = mfi.validbox();
+				fab.resize(bx, ncomp);
+				int n = 0;
+				for (const amrex::MultiFab *mf : fields[lev])
+				{
+					fab.copy((*mf)[mfi], bx, 0, bx, n, mf->nComp());
+					n += mf->nComp();
+				}
+
+				offset[mfi.index()] = datafile.tellp();
+				fab.writeOn(datafile);
+
+				for (int n = 0; n < ncomp; n++)
+				{
+					min[mfi.index()*ncomp + n] = fab.min(bx,n);
+					max[mfi.index()*ncomp + n] = fab.max(bx,n);
+				}
+			}
+		}
+
+		// Every box is owned by exactly one rank, so a sum gathers the metadata.
+		amrex::ParallelDescriptor::ReduceLongSum(offset.data(), offset.size(), ioproc);
+		amrex::ParallelDescriptor::ReduceRealSum(min.data(), min.size(), ioproc);
+		amrex::ParallelDescriptor::ReduceRealSum(max.data(), max.size(), ioproc);
+
+		//
+		// MultiFab header, in the format read by amrex::VisMF::Read
+		//
+		if (amrex::ParallelDescriptor::IOProcessor())
+		{
+			std::ofstream headerfile(fullprefix + "_H", std::ofstream::out | std::ofstream::trunc);
+			if (!headerfile.good()) Util::Abort(INFO,"Could not open ",fullprefix,"_H");
+			headerfile.setf(std::ios::floatfield, std::ios::scientific);
+			headerfile.precision(15);
+
+			headerfile << amrex::VisMF::Header::Version_v1 << '\n';
+			headerfile << int(amrex::VisMF::OneFilePerCPU) << '\n';
+			headerfile << ncomp << '\n';
+			headerfile << 0 << '\n'; // no ghost cells are written
+			ba.writeOn(headerfile);
+			headerfile << '\n';
+
+			headerfile << ba.size() << '\n';
+			for (int i = 0; i < ba.size(); i++)
+				headerfile << "FabOnDisk: " << amrex::Concatenate("Cell_D_", dm[i], 5) << ' ' << offset[i] << '\n';
+			headerfile << '\n';
+
+			headerfile << ba.size() << ',' << ncomp << '\n';
+			for (int i = 0; i < ba.size(); i++)
+			{
+				for (int n = 0; n < ncomp; n++) headerfile << min[i*ncomp + n] << ',';
+				headerfile << '\n';
+			}
+			headerfile << '\n';
+			headerfile << ba.size() << ',' << ncomp << '\n';
+			for (int i = 0; i < ba.size(); i++)
+			{
+				for (int n = 0; n < ncomp; n++) headerfile << max[i*ncomp + n] << ',';
+				headerfile << '\n';
+			}
+			headerfile << '\n';
+		}
+	}
+
+	amrex::ParallelDescriptor::Barrier();
+}
+
+}
@@ -13,6 +13,7 @@ CahnHilliard::CahnHilliard() : Integrator()
 	RegisterNewFab(etanewmf, bc, ncomp, nghost, "Eta",true);
 	RegisterNewFab(etaoldmf, bc, ncomp, nghost, "EtaOld",false);
 	RegisterNewFab(intermediate, bc, ncomp, nghost, "int",false);
+	eta_flux = RegisterFlux(etanewmf);
 	LPInfo info;
 	op.define(geom,grids,dmap,*bc,info);
 }
@@ -45,35 +46,55 @@ CahnHilliard::Advance (int lev, Set::Scalar /*time*/, Set::Scalar dt)
 {
 	std::swap(etaoldmf[lev], etanewmf[lev]);
 	const amrex::Real* DX = geom[lev].CellSize();
+
+	// Chemical potential, including one layer of ghost cells so that the
+	// second pass below sees the same values on both sides of every tile edge
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 	for ( amrex::MFIter mfi(*etanewmf[lev],true); mfi.isValid(); ++mfi )
 	{
-		const amrex::Box& bx = mfi.tilebox();
+		const amrex::Real tile_start = amrex::second();
+		const amrex::Box& bx = mfi.growntilebox(1);
 		amrex::Array4<const amrex::Real> const& eta = etaoldmf[lev]->array(mfi);
 		amrex::Array4<amrex::Real> const& inter    = intermediate[lev]->array(mfi);
-		amrex::Array4<amrex::Real> const& etanew    = etanewmf[lev]->array(mfi);
 
 		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
-				Set::Scalar lap =
-				 	Numeric::Stencil<Set::Scalar,2,0,0>::D(eta,i,j,k,0,DX) +
-				 	Numeric::Stencil<Set::Scalar,2,0,0>::D(eta,i,j,k,0,DX);
-
 				inter(i,j,k) =
 				 	eta(i,j,k)*eta(i,j,k)*eta(i,j,k)
 				 	- eta(i,j,k)
-				 	- gamma*lap;
-
-
-				etanew(i,j,k) = eta(i,j,k) - dt*inter(i,j,k); // Allen Cahn
+				 	- gamma*Numeric::Laplacian(eta,i,j,k,0,DX);
 			});
+		AddCost(lev, mfi, amrex::second() - tile_start);
+	}
 
-		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
-				Set::Scalar lap = 
-				 	Numeric::Stencil<Set::Scalar,2,0,0>::D(inter,i,j,k,0,DX) +
-				 	Numeric::Stencil<Set::Scalar,2,0,0>::D(inter,i,j,k,0,DX);
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+	for ( amrex::MFIter mfi(*etanewmf[lev],true); mfi.isValid(); ++mfi )
+	{
+		const amrex::Real tile_start = amrex::second();
+		const amrex::Box& bx = mfi.tilebox();
+		amrex::Array4<const amrex::Real> const& eta = etaoldmf[lev]->array(mfi);
+		amrex::Array4<const amrex::Real> const& inter = intermediate[lev]->array(mfi);
+		amrex::Array4<amrex::Real> const& etanew    = etanewmf[lev]->array(mfi);
 
-				etanew(i,j,k) = eta(i,j,k) + dt*lap;
+		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
+				etanew(i,j,k) = eta(i,j,k) + dt*Numeric::Laplacian(inter,i,j,k,0,DX);
 			});
 
+		// Fluxes F = -grad(inter) (times dt) used above, for refluxing
+		if (RefluxOn())
+			for (int d = 0; d < AMREX_SPACEDIM; d++)
+			{
+				amrex::Array4<Set::Scalar> const& flux = Flux(eta_flux,lev,d).array(mfi);
+				const amrex::IntVect e = amrex::IntVect::TheDimensionVector(d);
+				amrex::ParallelFor (mfi.nodaltilebox(d),[=] AMREX_GPU_DEVICE(int i, int j, int k){
+						amrex::IntVect iv(AMREX_D_DECL(i,j,k));
+						flux(iv) += - dt * (inter(iv) - inter(iv - e)) / DX[d];
+					});
+			}
+		AddCost(lev, mfi, amrex::second() - tile_start);
 	}
 }
 
@@ -1,5 +1,6 @@
 #include "Flame.H"
 #include "BC/Constant.H"
+#include "Numeric/Stencil.H"
 
 namespace Integrator
 {
@@ -76,10 +77,15 @@ Flame::Flame () : Integrator()
   RegisterNewFab(Eta,      EtaBC,  1, 1, "Eta", true);
   RegisterNewFab(Eta_old,  EtaBC,  1, 1, "Eta_old", false);
   RegisterNewFab(FlameSpeedFab, EtaBC,  1, 1, "FlameSpeed",true);
+
+  RegisterRefinementCriterion(Eta, 0.001, TagCriterion::GradientVolume);
 }
 
 void Flame::Initialize (int lev)
 {
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 	for (amrex::MFIter mfi(*Temp[lev],true); mfi.isValid(); ++mfi)
 		{
 			const amrex::Box& box = mfi.tilebox();
@@ -109,124 +115,83 @@ void Flame::Initialize (int lev)
 
 void Flame::Advance (int lev, amrex::Real time, amrex::Real dt)
 {
+  BL_PROFILE("Flame::Advance");
   std::swap(Eta_old [lev], Eta [lev]);
   std::swap(Temp_old[lev], Temp[lev]);
 
-  static amrex::IntVect AMREX_D_DECL(dx(AMREX_D_DECL(1,0,0)),
-												 dy(AMREX_D_DECL(0,1,0)),
-												 dz(AMREX_D_DECL(0,0,1)));
-
   const amrex::Real* DX = geom[lev].CellSize();
 
-  amrex::Real a0=w0, a1=0.0, a2= -5*w1 + 16*w12 - 11*a0, a3=14*w1 - 32*w12 + 18*a0, a4=-8*w1 + 16*w12 - 8*a0;
+  const amrex::Real a0=w0, a1=0.0, a2= -5*w1 + 16*w12 - 11*a0, a3=14*w1 - 32*w12 + 18*a0, a4=-8*w1 + 16*w12 - 8*a0;
 
-  for ( amrex::MFIter mfi(*Temp[lev],true); mfi.isValid(); ++mfi )
-    {
-      const amrex::Box& bx = mfi.tilebox();
+  // Temperature is held fixed until the flame has developed
+  const amrex::Real temperature_delay = 0.05;
+  const bool evolve_temperature = (time >= temperature_delay);
 
-      amrex::FArrayBox &Eta_box		= (*Eta[lev])[mfi];
-      amrex::FArrayBox &Eta_old_box		= (*Eta_old[lev])[mfi];
-      amrex::FArrayBox &Temp_box		= (*Temp[lev])[mfi];
-      amrex::FArrayBox &Temp_old_box	= (*Temp_old[lev])[mfi];
-      amrex::FArrayBox &FlameSpeed	= (*FlameSpeedFab[lev])[mfi];
+  UpdateNarrowBand(lev, {&Eta_old, &Temp_old}, {&Eta, &Temp});
 
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for ( amrex::MFIter mfi(*Temp[lev],amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi )
+    {
+      const amrex::Real tile_start = amrex::second();
+      const amrex::Box& bx = mfi.tilebox();
 
-		AMREX_D_TERM(for (int i = bx.loVect()[0]; i<=bx.hiVect()[0]; i++),
-						 for (int j = bx.loVect()[1]; j<=bx.hiVect()[1]; j++),
-						 for (int k = bx.loVect()[2]; k<=bx.hiVect()[2]; k++))
-			{
-				amrex::IntVect m(AMREX_D_DECL(i,j,k));
+      if (!NarrowBandActive(lev,mfi))
+        {
+          (*Eta[lev])[mfi].copy((*Eta_old[lev])[mfi], bx);
+          (*Temp[lev])[mfi].copy((*Temp_old[lev])[mfi], bx);
+          AddCost(lev, mfi, amrex::second() - tile_start);
+          continue;
+        }
+      if (!evolve_temperature) (*Temp[lev])[mfi].copy((*Temp_old[lev])[mfi], bx);
+
+      amrex::Array4<const amrex::Real> const& eta_old    = (*Eta_old[lev]).array(mfi);
+      amrex::Array4<amrex::Real>       const& eta_new    = (*Eta[lev]).array(mfi);
+      amrex::Array4<const amrex::Real> const& temp_old   = (*Temp_old[lev]).array(mfi);
+      amrex::Array4<amrex::Real>       const& temp_new   = (*Temp[lev]).array(mfi);
+      amrex::Array4<const amrex::Real> const& flamespeed = (*FlameSpeedFab[lev]).array(mfi);
+
+      amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
 				//
 				// Phase field evolution
 				//
+				const amrex::Real eta = eta_old(i,j,k);
+				const amrex::Real eta_lap = Numeric::Laplacian(eta_old,i,j,k,0,DX);
 
-				amrex::Real M_dev = fs_min + FlameSpeed(m)*(fs_max-fs_min)/(amrex::Real)fs_number;
+				amrex::Real M_dev = fs_min + flamespeed(i,j,k)*(fs_max-fs_min)/(amrex::Real)fs_number;
 
-				amrex::Real eta_lap = AMREX_D_TERM((Eta_old_box(m+dx) - 2.*Eta_old_box(m) + Eta_old_box(m-dx))/DX[0]/DX[0],
-															  + (Eta_old_box(m+dy) - 2.*Eta_old_box(m) + Eta_old_box(m-dy))/DX[1]/DX[1],
-															  + (Eta_old_box(m+dz) - 2.*Eta_old_box(m) + Eta_old_box(m-dz))/DX[2]/DX[2]);
-	     
-	     
-				amrex::Real oldeta = Eta_old_box(amrex::IntVect(AMREX_D_DECL(i,j,k)));
-				Eta_box(amrex::IntVect(AMREX_D_DECL(i,j,k))) = oldeta -
-					(M + M_dev) * dt * (a1 + 2*a2*oldeta + 3*a3*oldeta*oldeta + 4*a4*oldeta*oldeta*oldeta
+				eta_new(i,j,k) = eta -
+					(M + M_dev) * dt * (a1 + 2*a2*eta + 3*a3*eta*eta + 4*a4*eta*eta*eta
 								 - kappa*eta_lap);
 
 				//
 				// Temperature evolution
 				//
-	    
-				//if (0) // todo ignore temperature for the time being
-				//if (Eta_box(amrex::IntVect(i,j))>0.01)
-				//{
-				amrex::Real temperature_delay = 0.05;
-				if (time<temperature_delay) continue;
-
-				AMREX_D_TERM(amrex::Real eta_gradx = (Eta_old_box(m+dx) - Eta_old_box(m-dx))/(2*DX[0]);,
-								 amrex::Real eta_grady = (Eta_old_box(m+dy) - Eta_old_box(m-dy))/(2*DX[1]);,
-								 amrex::Real eta_gradz = (Eta_old_box(m+dz) - Eta_old_box(m-dz))/(2*DX[2]););
-				
-				AMREX_D_TERM(amrex::Real T_gradx = (Temp_old_box(m+dx) - Temp_old_box(m-dx))/(2*DX[0]);,
-								 amrex::Real T_grady = (Temp_old_box(m+dy) - Temp_old_box(m-dy))/(2*DX[1]);,
-								 amrex::Real T_gradz = (Temp_old_box(m+dz) - Temp_old_box(m-dz))/(2*DX[2]););
-
-				amrex::Real eta_grad_mag = sqrt(AMREX_D_TERM(eta_gradx*eta_gradx, + eta_grady*eta_grady, + eta_gradz*eta_gradz));
-
-				amrex::Real T_lap = 
-					AMREX_D_TERM((Temp_old_box(m+dx) - 2.*Temp_old_box(m) + Temp_old_box(m-dx))/DX[0]/DX[0],
-						     + (Temp_old_box(m+dy) - 2.*Temp_old_box(m) + Temp_old_box(m-dy))/DX[1]/DX[1],
-						     + (Temp_old_box(m+dz) - 2.*Temp_old_box(m) + Temp_old_box(m-dz))/DX[2]/DX[2]);
-	    
-				amrex::Real rho = (rho1-rho0)*Eta_old_box(m) + rho0;
-				amrex::Real K   = (k1-k0)*Eta_old_box(m) + k0;
-				amrex::Real cp  = (cp1-cp0)*Eta_old_box(m) + cp0;
-
-				Temp_box(m) =
-					Temp_old_box(m)
-					+ (dt/rho/cp) * ((k1-k0)*(AMREX_D_TERM(eta_gradx*T_gradx,
-									       + eta_grady*T_grady,
-									       + eta_gradz*T_gradz))
-							 + K *T_lap  + (w1 - w0 - qdotburn)*eta_grad_mag);
-
-				if (std::isnan(Temp_box(amrex::IntVect(AMREX_D_DECL(i,j,k)))))
-					Util::Abort(INFO, "NaN encountered");
-			}
-    }
-}
+				if (!evolve_temperature) return;
 
+				const Set::Vector eta_grad = Numeric::Gradient(eta_old,i,j,k,0,DX);
+				const Set::Vector T_grad   = Numeric::Gradient(temp_old,i,j,k,0,DX);
+				const amrex::Real T_lap    = Numeric::Laplacian(temp_old,i,j,k,0,DX);
 
+				const amrex::Real rho = (rho1-rho0)*eta + rho0;
+				const amrex::Real K   = (k1-k0)*eta + k0;
+				const amrex::Real cp  = (cp1-cp0)*eta + cp0;
 
-void Flame::TagCellsForRefinement (int lev, amrex::TagBoxArray& tags, amrex::Real /*time*/, int /*ngrow*/)
-{
-
-	const amrex::Real* dx      = geom[lev].CellSize();
+				temp_new(i,j,k) =
+					temp_old(i,j,k)
+					+ (dt/rho/cp) * ((k1-k0)*eta_grad.dot(T_grad)
+							 + K*T_lap + (w1 - w0 - qdotburn)*eta_grad.lpNorm<2>());
 
-	const amrex::MultiFab& state = *Temp[lev];
-	//amrex::Array<int>  itags;
-	
-	for (amrex::MFIter mfi(state,true); mfi.isValid(); ++mfi)
-		{
-			const amrex::Box&  bx  = mfi.tilebox();
+				if (std::isnan(temp_new(i,j,k)))
+					Util::Abort(INFO, "NaN encountered");
+			});
+      AddCost(lev, mfi, amrex::second() - tile_start);
+    }
+}
 
-			amrex::TagBox&     tag  = tags[mfi];
-	    
-			//amrex::BaseFab<Real> &Eta_box = (*Temp[lev])[mfi];
-			amrex::BaseFab<amrex::Real> &Eta_box = (*Eta[lev])[mfi];
 
-			for (int i = bx.loVect()[0]; i<=bx.hiVect()[0]; i++)
-				for (int j = bx.loVect()[1]; j<=bx.hiVect()[1]; j++)
-#if BL_SPACEDIM>2
-					for (int k = bx.loVect()[2]; k<=bx.hiVect()[2]; k++)
-#endif
-						{
-							amrex::Real gradx = (Eta_box(amrex::IntVect(AMREX_D_DECL(i+1,j,k))) - Eta_box(amrex::IntVect(AMREX_D_DECL(i-1,j,k))))/(2.*dx[0]);
-							amrex::Real grady = (Eta_box(amrex::IntVect(AMREX_D_DECL(i,j+1,k))) - Eta_box(amrex::IntVect(AMREX_D_DECL(i,j-1,k))))/(2.*dx[1]);
-							amrex::Real gradz = (Eta_box(amrex::IntVect(AMREX_D_DECL(i,j,k+1))) - Eta_box(amrex::IntVect(AMREX_D_DECL(i,j,k-1))))/(2.*dx[2]);
-							if (dx[0]*dx[1]*dx[2]*(gradx*gradx + grady*grady + gradz*gradz)>0.001) tag(amrex::IntVect(AMREX_D_DECL(i,j,k))) = amrex::TagBox::SET;
-						}
-		}
 
-}
 void Flame::Regrid(int lev, Set::Scalar /* time */)
 {
 	FlameSpeedFab[lev]->setVal(0.0);
@@ -105,6 +105,7 @@ Fracture::Fracture() :
 
         RegisterNewFab(crack.field,     crack.bc, 1, number_of_ghost_cells, "c",		true);
         RegisterNewFab(crack.field_old, crack.bc, 1, number_of_ghost_cells, "c_old",	true);
+        RegisterRefinementCriterion(crack.field, crack.refinement_threshold);
         switch (fracture_type)
         {
             case FractureType::Brittle: 
@@ -161,6 +162,11 @@ Fracture::Fracture() :
         pp_elastic.query("use_fsmooth",		sol.use_fsmooth);
         pp_elastic.query("agglomeration", 	sol.agglomeration);
         pp_elastic.query("consolidation", 	sol.consolidation);
+        pp_elastic.query("galerkin",		sol.galerkin);
+        pp_elastic.query("mixed_precision",	sol.mixed_precision);
+        pp_elastic.query("smoother",		sol.smoother);
+        pp_elastic.query("chebyshev_degree", sol.chebyshev_degree);
+        pp_elastic.query("krylov",			sol.krylov);
 
         pp_elastic.query("bottom_solver",       sol.bottom_solver);
         pp_elastic.query("linop_maxorder",      sol.linop_maxorder);
@@ -209,6 +215,56 @@ Fracture::Fracture() :
         pp_plastic.query("tol_abs", plastic.tol_abs);
     }
 
+    //==================================================
+    // Acceleration of the staggered iteration
+    {
+        IO::ParmParse pp_stagger("stagger");
+        std::string stagger_type = "none";
+        pp_stagger.query("type", stagger_type);
+        pp_stagger.query("omega", stagger.omega_init);
+        pp_stagger.query("omega_min", stagger.omega_min);
+        pp_stagger.query("omega_max", stagger.omega_max);
+        pp_stagger.query("depth", stagger.depth);
+
+        if (stagger_type == "none") stagger.type = AccelerationType::None;
+        else if (stagger_type == "relaxation") stagger.type = AccelerationType::Relaxation;
+        else if (stagger_type == "aitken") stagger.type = AccelerationType::Aitken;
+        else if (stagger_type == "anderson") stagger.type = AccelerationType::Anderson;
+        else Util::Abort(INFO, "Invalid stagger.type ", stagger_type, " (must be none, relaxation, aitken or anderson)");
+
+        if (stagger.type == AccelerationType::Relaxation && !pp_stagger.contains("omega"))
+            Util::Abort(INFO, "stagger.type = relaxation requires stagger.omega");
+
+        if (stagger.omega_min <= 0.0 || stagger.omega_min > stagger.omega_max)
+            Util::Abort(INFO, "Must have 0 < stagger.omega_min <= stagger.omega_max");
+        stagger.omega = stagger.omega_init;
+
+        if (stagger.type == AccelerationType::Anderson && stagger.depth < 1)
+            Util::Abort(INFO, "stagger.depth must be at least 1");
+
+        if (stagger.type != AccelerationType::None)
+            RegisterNewFab(stagger.residual, crack.bc, 1, number_of_ghost_cells, "stagger_residual", false);
+        if (stagger.type == AccelerationType::Aitken || stagger.type == AccelerationType::Anderson)
+            RegisterNewFab(stagger.residual_old, crack.bc, 1, number_of_ghost_cells, "stagger_residual_old", false);
+        if (stagger.type == AccelerationType::Anderson)
+        {
+            RegisterNewFab(stagger.update_old, crack.bc, 1, number_of_ghost_cells, "stagger_update_old", false);
+            // Sized before registering: RegisterNewFab keeps pointers to the fields
+            stagger.dr.resize(stagger.depth);
+            stagger.dg.resize(stagger.depth);
+            for (int j = 0; j < stagger.depth; j++)
+            {
+                RegisterNewFab(stagger.dr[j], crack.bc, 1, number_of_ghost_cells, "stagger_dr" + std::to_string(j), false);
+                RegisterNewFab(stagger.dg[j], crack.bc, 1, number_of_ghost_cells, "stagger_dg" + std::to_string(j), false);
+            }
+        }
+
+        RegisterIntegratedVariable(&stagger.iter, "stagger_iter", false);
+        RegisterIntegratedVariable(&stagger.omega, "stagger_omega", false);
+        RegisterIntegratedVariable(&stagger.residual_norm, "stagger_res_norm", false);
+        RegisterIntegratedVariable(&stagger.solves, "elastic_solves", false);
+    }
+
     //==================================================
     // Registering fabs now
     {
@@ -298,6 +354,8 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
 	}
     if(iter%sol.interval) return;
     loading.val = loading.init + ((double)loading.step)*loading.rate;
+    stagger.solves++;
+    stagger.solved = true;
 
     for (int ilev = 0; ilev < nlevels; ++ilev)
 	{
@@ -313,6 +371,9 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
     {
         for (int ilev = 0; ilev < nlevels; ++ilev)
         {
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
             for (amrex::MFIter mfi(*elastic.disp[ilev],true); mfi.isValid(); ++mfi)
             {
                 amrex::Box box = mfi.growntilebox(2);
@@ -326,30 +387,33 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
                 else if (fracture_type == FractureType::Ductile)
                     modelfab_d = (material.ductilemodel)[ilev]->array(mfi);
                 
+                const Set::Scalar m = crack.cracktype->DuctileExponent();
+                crack.cracktype->Dispatch([&](auto G, auto) {
+                using g = decltype(G);
                 amrex::ParallelFor (box,[=] AMREX_GPU_DEVICE(int i, int j, int k){
                     Set::Scalar _temp = 0;
                     Set::Scalar mul = AMREX_D_PICK(0.5,0.25,0.125);
                     if (fracture_type == FractureType::Brittle)
                     {
                         _temp =  mul*(AMREX_D_TERM(	
-                                            crack.cracktype->g_phi(c_new(i,j,k,0),0.) + crack.cracktype->g_phi(c_new(i-1,j,k,0),0.)
+                                            g::g(c_new(i,j,k,0),0.,m) + g::g(c_new(i-1,j,k,0),0.,m)
                                             , 
-                                            + crack.cracktype->g_phi(c_new(i,j-1,k,0),0.) + crack.cracktype->g_phi(c_new(i-1,j-1,k,0),0.)
+                                            + g::g(c_new(i,j-1,k,0),0.,m) + g::g(c_new(i-1,j-1,k,0),0.,m)
                                             , 
-                                            + crack.cracktype->g_phi(c_new(i,j,k-1,0),0.) + crack.cracktype->g_phi(c_new(i-1,j,k-1,0),0.)
-                                            + crack.cracktype->g_phi(c_new(i,j-1,k-1,0),0.) + crack.cracktype->g_phi(c_new(i-1,j-1,k-1,0),0.))
+                                            + g::g(c_new(i,j,k-1,0),0.,m) + g::g(c_new(i-1,j,k-1,0),0.,m)
+                                            + g::g(c_new(i,j-1,k-1,0),0.,m) + g::g(c_new(i-1,j-1,k-1,0),0.,m))
                                             );
                     }
                     else if (fracture_type == FractureType::Ductile)
                     {
                         Set::Scalar p = modelfab_d(i,j,k).curr.alpha;
                         _temp =  mul*(AMREX_D_TERM(	
-                                            crack.cracktype->g_phi(c_new(i,j,k,0),p) + crack.cracktype->g_phi(c_new(i-1,j,k,0),p)
+                                            g::g(c_new(i,j,k,0),p,m) + g::g(c_new(i-1,j,k,0),p,m)
                                             , 
-                                            + crack.cracktype->g_phi(c_new(i,j-1,k,0),p) + crack.cracktype->g_phi(c_new(i-1,j-1,k,0),p)
+                                            + g::g(c_new(i,j-1,k,0),p,m) + g::g(c_new(i-1,j-1,k,0),p,m)
                                             , 
-                                            + crack.cracktype->g_phi(c_new(i,j,k-1,0),p) + crack.cracktype->g_phi(c_new(i-1,j,k-1,0),p)
-                                            + crack.cracktype->g_phi(c_new(i,j-1,k-1,0),p) + crack.cracktype->g_phi(c_new(i-1,j-1,k-1,0),p))
+                                            + g::g(c_new(i,j,k-1,0),p,m) + g::g(c_new(i-1,j,k-1,0),p,m)
+                                            + g::g(c_new(i,j-1,k-1,0),p,m) + g::g(c_new(i-1,j-1,k-1,0),p,m))
                                             );
                     }
                     
@@ -365,6 +429,7 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
                         modelfab_d(i,j,k,0).DegradeYieldSurface(std::min(1.-_temp,1.-crack.scaleModulusMax));
                     }
                 });
+                });
             }
             if (fracture_type == FractureType::Brittle) Util::RealFillBoundary(*material.brittlemodel[ilev],geom[ilev]);
             else Util::RealFillBoundary(*material.ductilemodel[ilev],geom[ilev]);
@@ -454,6 +519,9 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
         {
             op_b.define(geom, grids, dmap, info);
             op_b.setMaxOrder(sol.linop_maxorder);
+            op_b.SetGalerkin(sol.galerkin);
+            op_b.SetMixedPrecision(sol.mixed_precision);
+            op_b.SetSmoother(sol.smoother, sol.chebyshev_degree);
             op_b.SetBC(&elastic.brittlebc);
             Solver::Nonlocal::Newton<brittle_fracture_model_type>  solver(op_b);
             solver.setMaxIter(sol.max_iter);
@@ -464,8 +532,8 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
             solver.setBottomMaxIter(sol.bottom_max_iter);
             solver.setBottomTolerance(sol.cg_tol_rel) ;
             solver.setBottomToleranceAbs(sol.cg_tol_abs) ;
-            if (sol.bottom_solver == "cg") solver.setBottomSolver(MLMG::BottomSolver::cg);
-            else if (sol.bottom_solver == "bicgstab") solver.setBottomSolver(MLMG::BottomSolver::bicgstab);
+            solver.setBottomSolver(sol.bottom_solver);
+            solver.setKrylov(sol.krylov);
             solver.solve(elastic.disp, elastic.rhs, material.brittlemodel, sol.tol_rel, sol.tol_abs);
             solver.compResidual(elastic.residual,elastic.disp,elastic.rhs,material.brittlemodel);
         }
@@ -473,6 +541,9 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
         {
             op_d.define(geom, grids, dmap, info);
             op_d.setMaxOrder(sol.linop_maxorder);
+            op_d.SetGalerkin(sol.galerkin);
+            op_d.SetMixedPrecision(sol.mixed_precision);
+            op_d.SetSmoother(sol.smoother, sol.chebyshev_degree);
             op_d.SetBC(&elastic.ductilebc);
             Solver::Nonlocal::Newton<ductile_fracture_model_type>  solver(op_d);
             solver.setMaxIter(sol.max_iter);
@@ -483,8 +554,8 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
             solver.setBottomMaxIter(sol.bottom_max_iter);
             solver.setBottomTolerance(sol.cg_tol_rel) ;
             solver.setBottomToleranceAbs(sol.cg_tol_abs) ;
-            if (sol.bottom_solver == "cg") solver.setBottomSolver(MLMG::BottomSolver::cg);
-            else if (sol.bottom_solver == "bicgstab") solver.setBottomSolver(MLMG::BottomSolver::bicgstab);
+            solver.setBottomSolver(sol.bottom_solver);
+            solver.setKrylov(sol.krylov);
             solver.solve(elastic.disp, elastic.rhs, material.ductilemodel, sol.tol_rel, sol.tol_abs);
             solver.compResidual(elastic.residual,elastic.disp,elastic.rhs,material.ductilemodel);
         }
@@ -515,9 +586,13 @@ Fracture::TimeStepBegin(amrex::Real time, int iter)
             elastic.energy_pristine[ilev]->setVal(0.0);
             elastic.energy_pristine_old[ilev]->FillBoundary();
             
+#ifdef _OPENMP
+// SetF0 writes to the shared ductile model type, so ductile runs stay serial here
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion() && fracture_type == FractureType::Brittle)
+#endif
             for (amrex::MFIter mfi(*elastic.strain[ilev],true); mfi.isValid(); ++mfi)
             {
-                const amrex::Box& box = mfi.validbox();
+                const amrex::Box& box = mfi.tilebox();
                 amrex::Array4<Set::Scalar>	const& sig_box 		    = (*elastic.stress[ilev]).array(mfi);
                 amrex::Array4<const Set::Scalar> const& strain_box 	= (*elastic.strain[ilev]).array(mfi);
                 amrex::Array4<Set::Scalar> const& energy_box 		= (*elastic.energy_pristine[ilev]).array(mfi);
@@ -570,9 +645,21 @@ Fracture::Advance (int lev, Set::Scalar time, Set::Scalar dt)
 	static amrex::IntVect AMREX_D_DECL(	dx(AMREX_D_DECL(1,0,0)), dy(AMREX_D_DECL(0,1,0)), dz(AMREX_D_DECL(0,0,1)));
 	const Set::Scalar* DX = geom[lev].CellSize();
 
-    for ( amrex::MFIter mfi(*crack.field[lev],true); mfi.isValid(); ++mfi )
+    UpdateNarrowBand(lev, {&crack.field_old}, {&crack.field});
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( amrex::MFIter mfi(*crack.field[lev],amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi )
 	{
-		const amrex::Box& bx = mfi.validbox();
+		const amrex::Real tile_start = amrex::second();
+		const amrex::Box& bx = mfi.tilebox();
+        if (!NarrowBandActive(lev,mfi))
+        {
+            (*crack.field[lev])[mfi].copy((*crack.field_old[lev])[mfi], bx);
+            AddCost(lev, mfi, amrex::second() - tile_start);
+            continue;
+        }
 		amrex::Array4<const Set::Scalar> const& c_old = (*crack.field_old[lev]).array(mfi);
 		amrex::Array4<Set::Scalar> const& df = (*crack.driving_force[lev]).array(mfi);
 		amrex::Array4<Set::Scalar> const& c_new = (*crack.field[lev]).array(mfi);
@@ -582,6 +669,10 @@ Fracture::Advance (int lev, Set::Scalar time, Set::Scalar dt)
         if (fracture_type == FractureType::Ductile)
             model_box 	= material.ductilemodel[lev]->array(mfi);
 
+        const Set::Scalar m = crack.cracktype->DuctileExponent();
+        crack.cracktype->Dispatch([&](auto G, auto W) {
+        using g = decltype(G);
+        using w = decltype(W);
         amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
 
 			Set::Scalar rhs = 0.0;
@@ -590,8 +681,8 @@ Fracture::Advance (int lev, Set::Scalar time, Set::Scalar dt)
 			// Elastic component of the driving force
 			Set::Scalar en_cell = Numeric::Interpolate::NodeToCellAverage(energy_box,i,j,k,0);
             if (std::isnan(en_cell)) Util::Abort(INFO, "Nans detected in en_cell. energy_box(i,j,k,0) = ", energy_box(i,j,k,0));
-			df(i,j,k,0) = crack.cracktype->Dg_phi(c_old(i,j,k,0),p)*en_cell*elastic.df_mult;
-			rhs += crack.cracktype->Dg_phi(c_old(i,j,k,0),p)*en_cell*elastic.df_mult;
+			df(i,j,k,0) = g::Dg(c_old(i,j,k,0),p,m)*en_cell*elastic.df_mult;
+			rhs += g::Dg(c_old(i,j,k,0),p,m)*en_cell*elastic.df_mult;
 
 			// Boundary terms
 			Set::Vector Dc = Numeric::Gradient(c_old, i, j, k, 0, DX);
@@ -602,10 +693,10 @@ Fracture::Advance (int lev, Set::Scalar time, Set::Scalar dt)
 
 			if (!anisotropy.on || time < anisotropy.tstart)
 			{
-				df(i,j,k,1) = crack.cracktype->Gc(Theta)*crack.cracktype->Dw_phi(c_old(i,j,k,0),p)/(4.0*crack.cracktype->Zeta(Theta))*crack.mult_df_Gc;
+				df(i,j,k,1) = crack.cracktype->Gc(Theta)*w::Dw(c_old(i,j,k,0))/(4.0*crack.cracktype->Zeta(Theta))*crack.mult_df_Gc;
 				df(i,j,k,2) = 2.0*crack.cracktype->Zeta(Theta)*crack.cracktype->Gc(Theta)*laplacian*crack.mult_df_lap;
 
-				rhs += crack.cracktype->Gc(Theta)*crack.cracktype->Dw_phi(c_old(i,j,k,0),p)/(4.0*crack.cracktype->Zeta(Theta))*crack.mult_df_Gc;
+				rhs += crack.cracktype->Gc(Theta)*w::Dw(c_old(i,j,k,0))/(4.0*crack.cracktype->Zeta(Theta))*crack.mult_df_Gc;
 				rhs -= 2.0*crack.cracktype->Zeta(Theta)*crack.cracktype->Gc(Theta)*laplacian*crack.mult_df_lap;
 			}
 			else
@@ -624,13 +715,13 @@ Fracture::Advance (int lev, Set::Scalar time, Set::Scalar dt)
 				Set::Scalar cos2Theta = cos(2.0*Theta);
 
 				Set::Scalar zeta = crack.cracktype->Zeta(Theta);
-				Set::Scalar ws = crack.cracktype->w_phi(c_old(i,j,k,0),p)/(4.0*zeta*normgrad*normgrad);
+				Set::Scalar ws = w::w(c_old(i,j,k,0))/(4.0*zeta*normgrad*normgrad);
 				
 				if( std::isnan(ws)) Util::Abort(INFO, "nan at m=",i,",",j,",",k);
 				if( std::isinf(ws)) ws = 1.0E6;
 
 				Set::Scalar Boundary_term = 0.;
-				Boundary_term += crack.cracktype->Gc(Theta)*crack.cracktype->Dw_phi(c_old(i,j,k,0),p)/(4.0*crack.cracktype->Zeta(Theta));
+				Boundary_term += crack.cracktype->Gc(Theta)*w::Dw(c_old(i,j,k,0))/(4.0*crack.cracktype->Zeta(Theta));
 				Boundary_term -= 2.0*crack.cracktype->Gc(Theta)*crack.cracktype->Zeta(Theta)*laplacian;
 
 				Boundary_term += crack.cracktype->DGc(Theta)
@@ -668,20 +759,22 @@ Fracture::Advance (int lev, Set::Scalar time, Set::Scalar dt)
 
             else
             {
-                df(i,j,k,3) = crack.cracktype->Dg_phi(c_old(i,j,k,0),p)*(material.ductilemodeltype.OriginalPlasticEnergy());
-                rhs += crack.cracktype->Dg_phi(c_old(i,j,k,0),p)*(material.ductilemodeltype.OriginalPlasticEnergy());
+                df(i,j,k,3) = g::Dg(c_old(i,j,k,0),p,m)*(material.ductilemodeltype.OriginalPlasticEnergy());
+                rhs += g::Dg(c_old(i,j,k,0),p,m)*(material.ductilemodeltype.OriginalPlasticEnergy());
 
                 df(i,j,k,4) = rhs;
 			    df(i,j,k,5) = max(0.,rhs-crack.cracktype->DrivingForceThreshold(c_old(i,j,k,0)));
             }
             
-			if(std::isnan(rhs)) Util::Abort(INFO, "Dwphi = ", crack.cracktype->Dw_phi(c_old(i,j,k,0),p),". c_old(i,j,k,0) = ",c_old(i,j,k,0));
+			if(std::isnan(rhs)) Util::Abort(INFO, "Dwphi = ", w::Dw(c_old(i,j,k,0)),". c_old(i,j,k,0) = ",c_old(i,j,k,0));
 			c_new(i,j,k,0) = c_old(i,j,k,0) - dt*std::max(0., rhs - crack.cracktype->DrivingForceThreshold(c_old(i,j,k,0)))*crack.cracktype->Mobility(c_old(i,j,k,0));
 
 			if(c_new(i,j,k,0) > 1.0) {Util::Message(INFO, "cnew = ", c_new(i,j,k,0) ,", resetting to 1.0"); c_new(i,j,k,0) = 1.;}
 			if(c_new(i,j,k,0) < 0.0) {Util::Message(INFO, "cnew = ", c_new(i,j,k,0) ,", resetting to 0.0"); c_new(i,j,k,0) = 0.;}
 		});
+        });
 
+        AddCost(lev, mfi, amrex::second() - tile_start);
     }
 }
 
@@ -701,52 +794,206 @@ Fracture::Integrate(int amrlev, Set::Scalar /*time*/, int /*step*/,const amrex::
         ep_old = (*plastic.strain_old[amrlev]).array(mfi);
     }
 
-    amrex::ParallelFor(box, [=] AMREX_GPU_DEVICE(int i, int j, int k) 
+    Set::Scalar &crack_error_norm = Accumulator(crack.error_norm);
+    Set::Scalar &crack_norm = Accumulator(crack.norm);
+    Set::Scalar &plastic_norm = Accumulator(plastic.norm);
+    Set::Scalar &plastic_error_norm = Accumulator(plastic.error_norm);
+
+    amrex::ParallelFor(box, [&](int i, int j, int k) 
     {
-		crack.error_norm += ((c_new(i,j,k,0)-c_old(i,j,k,0))*(c_new(i,j,k,0)-c_old(i,j,k,0)))*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
-		crack.norm += c_new(i,j,k,0)*c_new(i,j,k,0)*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
+		crack_error_norm += ((c_new(i,j,k,0)-c_old(i,j,k,0))*(c_new(i,j,k,0)-c_old(i,j,k,0)))*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
+		crack_norm += c_new(i,j,k,0)*c_new(i,j,k,0)*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
         
         if(fracture_type == FractureType::Ductile)
         {
             for (int n = 0; n < AMREX_SPACEDIM*AMREX_SPACEDIM; n++)
             {
-                plastic.norm += ep_new(i,j,k,n)*ep_new(i,j,k,n)*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
-                plastic.error_norm += (ep_new(i,j,k,n)-ep_old(i,j,k,n))*(ep_new(i,j,k,n)-ep_old(i,j,k,n))*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
+                plastic_norm += ep_new(i,j,k,n)*ep_new(i,j,k,n)*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
+                plastic_error_norm += (ep_new(i,j,k,n)-ep_old(i,j,k,n))*(ep_new(i,j,k,n)-ep_old(i,j,k,n))*(AMREX_D_TERM(DX[0],*DX[1],*DX[2]));
             }
-            plastic.norm *= crack.cracktype->g_phi(c_new(i,j,k,0),0.0);
-		    plastic.error_norm *= crack.cracktype->g_phi(c_new(i,j,k,0),0.);
+            plastic_norm *= crack.cracktype->g_phi(c_new(i,j,k,0),0.0);
+		    plastic_error_norm *= crack.cracktype->g_phi(c_new(i,j,k,0),0.);
         }
 	});
 }
 
-void
-Fracture::TagCellsForRefinement (int lev, amrex::TagBoxArray &a_tags, amrex::Real /*time*/, int /*ngrow*/)
+Set::Scalar
+Fracture::StaggerDot(const Set::Field<Set::Scalar> &a, const Set::Field<Set::Scalar> &b,
+                     const amrex::Vector<amrex::iMultiFab> &mask)
 {
-	const amrex::Real *DX = geom[lev].CellSize();
-	const Set::Vector dx(DX);
-	const Set::Scalar dxnorm = dx.lpNorm<2>();
+    BL_PROFILE("Fracture::StaggerDot");
+    Set::Scalar dot = 0.0;
+    for (int lev = 0; lev <= finest_level; lev++)
+    {
+        const Set::Scalar* DX = geom[lev].CellSize();
+        const Set::Scalar volume = AMREX_D_TERM(DX[0],*DX[1],*DX[2]);
 
-	for (amrex::MFIter mfi(*crack.field[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-	{
-		const amrex::Box 							&bx 	= mfi.tilebox();
-		amrex::Array4<char> const 					&tags 	= a_tags.array(mfi);
-		amrex::Array4<const Set::Scalar> const 		&c_new 	= (*crack.field[lev]).array(mfi);
-		
-		amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-			Set::Vector grad = Numeric::Gradient(c_new, i, j, k, 0, DX);
-			if (dxnorm * grad.lpNorm<2>() > crack.refinement_threshold)
-				tags(i, j, k) = amrex::TagBox::SET;
-		});
-	}
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:dot)
+#endif
+        for (amrex::MFIter mfi(*a[lev],amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const amrex::Box& bx = mfi.tilebox();
+            amrex::Array4<const Set::Scalar> const& aa = (*a[lev]).array(mfi);
+            amrex::Array4<const Set::Scalar> const& bb = (*b[lev]).array(mfi);
+            amrex::Array4<const int> const& m = mask[lev].array(mfi);
+
+            amrex::ParallelFor (bx,[&](int i, int j, int k){
+                if (m(i,j,k)) dot += aa(i,j,k)*bb(i,j,k)*volume;
+            });
+        }
+    }
+    amrex::ParallelDescriptor::ReduceRealSum(dot);
+    return dot;
+}
+
+bool
+Fracture::AccelerateStaggered()
+{
+    BL_PROFILE("Fracture::AccelerateStaggered");
+
+    // Only the full map G (elastic solve + crack update) is relaxed; a bare
+    // crack step leaves c and the stored residuals untouched.
+    if (!stagger.solved) return false;
+    stagger.solved = false;
+
+    // Inner products are taken over uncovered cells only, weighted by cell volume
+    amrex::Vector<amrex::iMultiFab> mask(finest_level+1);
+    for (int lev = 0; lev <= finest_level; lev++)
+    {
+        if (lev < finest_level)
+            mask[lev] = amrex::makeFineMask(grids[lev], dmap[lev], grids[lev+1], refRatio(lev), 1, 0);
+        else
+        {
+            mask[lev].define(grids[lev], dmap[lev], 1, 0);
+            mask[lev].setVal(1);
+        }
+    }
+
+    // Unrelaxed crack update r_k = G(c_k) - c_k; its norm is the convergence measure
+    for (int lev = 0; lev <= finest_level; lev++)
+    {
+        amrex::MultiFab::Copy(*stagger.residual[lev], *crack.field[lev], 0, 0, 1, 0);
+        amrex::MultiFab::Subtract(*stagger.residual[lev], *crack.field_old[lev], 0, 0, 1, 0);
+    }
+    const Set::Scalar rr = StaggerDot(stagger.residual, stagger.residual, mask);
+    stagger.residual_norm = rr;
+
+    if (stagger.type == AccelerationType::Anderson)
+    {
+        // Append the newest differences to the ring buffer
+        if (stagger.history)
+        {
+            const int j = stagger.head;
+            for (int lev = 0; lev <= finest_level; lev++)
+            {
+                amrex::MultiFab::LinComb(*stagger.dr[j][lev], 1.0, *stagger.residual[lev], 0, -1.0, *stagger.residual_old[lev], 0, 0, 1, 0);
+                amrex::MultiFab::LinComb(*stagger.dg[j][lev], 1.0, *crack.field[lev], 0, -1.0, *stagger.update_old[lev], 0, 0, 1, 0);
+            }
+            stagger.head = (stagger.head + 1) % stagger.depth;
+            stagger.nhist = std::min(stagger.nhist + 1, stagger.depth);
+        }
+        for (int lev = 0; lev <= finest_level; lev++)
+        {
+            amrex::MultiFab::Copy(*stagger.residual_old[lev], *stagger.residual[lev], 0, 0, 1, 0);
+            amrex::MultiFab::Copy(*stagger.update_old[lev], *crack.field[lev], 0, 0, 1, 0);
+        }
+        stagger.history = true;
+
+        const int n = stagger.nhist;
+        if (n == 0) return true;
+
+        // gamma = argmin |r_k - dR gamma| from the (small) normal equations
+        Eigen::Matrix<Set::Scalar,Eigen::Dynamic,Eigen::Dynamic> A(n,n);
+        Eigen::Matrix<Set::Scalar,Eigen::Dynamic,1> b(n);
+        for (int p = 0; p < n; p++)
+        {
+            b(p) = StaggerDot(stagger.dr[p], stagger.residual, mask);
+            for (int q = 0; q <= p; q++)
+                A(p,q) = A(q,p) = StaggerDot(stagger.dr[p], stagger.dr[q], mask);
+        }
+        // (SVD, since the differences become nearly dependent close to convergence)
+        const Eigen::Matrix<Set::Scalar,Eigen::Dynamic,1> gamma = A.jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(b);
+
+        // c_{k+1} = G(c_k) - dG gamma, clipped to [0, c_k]
+        for (int lev = 0; lev <= finest_level; lev++)
+        {
+            for (int p = 0; p < n; p++)
+                amrex::MultiFab::Saxpy(*crack.field[lev], -gamma(p), *stagger.dg[p][lev], 0, 0, 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+            for (amrex::MFIter mfi(*crack.field[lev],amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const amrex::Box& bx = mfi.tilebox();
+                amrex::Array4<Set::Scalar> const& c_new = (*crack.field[lev]).array(mfi);
+                amrex::Array4<const Set::Scalar> const& c_old = (*crack.field_old[lev]).array(mfi);
+                amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
+                    c_new(i,j,k) = std::min(std::max(c_new(i,j,k), 0.0), c_old(i,j,k));
+                });
+            }
+            crack.field[lev]->FillBoundary();
+        }
+        return true;
+    }
+
+    //
+    // Aitken update of the relaxation factor:
+    //     omega_k = -omega_{k-1} (r_{k-1} . (r_k - r_{k-1})) / |r_k - r_{k-1}|^2
+    //
+    if (stagger.type == AccelerationType::Aitken && stagger.history)
+    {
+        const Set::Scalar ro = StaggerDot(stagger.residual, stagger.residual_old, mask);
+        const Set::Scalar oo = StaggerDot(stagger.residual_old, stagger.residual_old, mask);
+        const Set::Scalar num = ro - oo, den = rr - 2.0*ro + oo;
+        if (den > 0.0) stagger.omega = -stagger.omega*num/den;
+        stagger.omega = std::min(std::max(stagger.omega, stagger.omega_min), stagger.omega_max);
+    }
+    else stagger.omega = stagger.omega_init;
+
+    //
+    // Relaxed update. Because the crack update never increases c, any
+    // positive omega preserves irreversibility; only the bounds need enforcing.
+    //
+    const Set::Scalar omega = stagger.omega;
+    for (int lev = 0; lev <= finest_level; lev++)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (amrex::MFIter mfi(*crack.field[lev],amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const amrex::Box& bx = mfi.tilebox();
+            amrex::Array4<Set::Scalar> const& c_new = (*crack.field[lev]).array(mfi);
+            amrex::Array4<const Set::Scalar> const& c_old = (*crack.field_old[lev]).array(mfi);
+            amrex::Array4<const Set::Scalar> const& r = (*stagger.residual[lev]).array(mfi);
+
+            amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
+                c_new(i,j,k) = std::min(std::max(c_old(i,j,k) + omega*r(i,j,k), 0.0), 1.0);
+            });
+        }
+        crack.field[lev]->FillBoundary();
+        if (stagger.type == AccelerationType::Aitken)
+            amrex::MultiFab::Copy(*stagger.residual_old[lev], *stagger.residual[lev], 0, 0, 1, 0);
+    }
+    stagger.history = (stagger.type == AccelerationType::Aitken);
+    return true;
 }
 
 void
 Fracture::TimeStepComplete(amrex::Real time,int iter)
 {
+    stagger.iter++;
+    // Relaxing scales c_new - c_old, so an accelerated iteration is judged by
+    // its unrelaxed update instead of crack_err_norm
+    const bool accelerated = (stagger.type != AccelerationType::None) && AccelerateStaggered();
+
 	IntegrateVariables(time,iter);
 
-    Set::Scalar rel_c_err = crack.error_norm/crack.norm;
+    const Set::Scalar c_err = accelerated ? stagger.residual_norm : crack.error_norm;
+    Set::Scalar rel_c_err = c_err/crack.norm;
     Util::Message(INFO, "crack_err_norm = ", crack.error_norm);
+    if (accelerated) Util::Message(INFO, "unrelaxed crack update norm = ", stagger.residual_norm);
 	Util::Message(INFO, "c_new_norm = ", crack.norm);
     Util::Message(INFO, "crack relative error= ", rel_c_err);
 
@@ -758,11 +1005,16 @@ Fracture::TimeStepComplete(amrex::Real time,int iter)
         Util::Message(INFO, "plastic strain relative error= ", rel_ep_err);
     }
 
-    if (crack.error_norm > crack.tol_abs || rel_c_err > crack.tol_rel) return;
+    if (c_err > crack.tol_abs || rel_c_err > crack.tol_rel) return;
     if (fracture_type == FractureType::Ductile && (plastic.norm > plastic.tol_abs || plastic.error_norm > plastic.tol_rel)) return;
 
 	WritePlotFile("crack",(double)loading.step,loading.step);
 
+    Util::Message(INFO, "load step ", loading.step, " converged in ", stagger.iter, " staggered iterations");
+    stagger.iter = 0;
+    stagger.history = false;
+    stagger.nhist = stagger.head = 0;
+
 	loading.step++;
 	if(loading.val >= loading.max) SetStopTime(time-0.01);
 }
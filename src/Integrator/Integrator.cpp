@@ -5,8 +5,11 @@
 
 #include "Integrator.H"
 #include "IO/FileNameParse.H"
+#include "IO/WriteFields.H"
 #include "Util/Util.H"
+#include "Numeric/Stencil.H"
 #include <numeric>
+#include <algorithm>
 
 
 
@@ -59,6 +62,29 @@ Integrator::Integrator ()
 		pp.query("plot_int", thermo.plot_int);         // ALL processors
 		pp.query("plot_dt", thermo.plot_dt);         // ALL processors
 	}
+	{
+		amrex::ParmParse pp("amr.narrowband");
+		pp.query("on", narrowband.on);
+		pp.query("threshold", narrowband.threshold);
+		pp.query("sweep_int", narrowband.sweep_int);
+	}
+	{
+		amrex::ParmParse pp("amr");
+		pp.query("reflux", reflux.on);
+	}
+	{
+		amrex::ParmParse pp("amr.initialize");
+		pp.query("uncovered_only", initialization.uncovered_only);
+	}
+	{
+		amrex::ParmParse pp("amr.loadbalance");
+		pp.query("strategy", loadbalance.strategy);
+		loadbalance.interval = regrid_int;
+		pp.query("int", loadbalance.interval);
+		pp.query("threshold", loadbalance.threshold);
+		if (loadbalance.strategy != "none" && loadbalance.strategy != "knapsack" && loadbalance.strategy != "sfc")
+			Util::Abort(INFO,"Invalid amr.loadbalance.strategy: ",loadbalance.strategy, " (must be none, knapsack, or sfc)");
+	}
 
 
 	int nlevs_max = maxLevel() + 1;
@@ -67,6 +93,12 @@ Integrator::Integrator ()
 
 	t_new.resize(nlevs_max, 0.0);
 	t_old.resize(nlevs_max, -1.e100);
+	narrowband.active.resize(nlevs_max);
+	loadbalance.time.resize(nlevs_max, 0.0);
+	loadbalance.steps.resize(nlevs_max, 0);
+	loadbalance.cost.resize(nlevs_max);
+	loadbalance.measured.resize(nlevs_max, 0);
+	reflux.pending.resize(nlevs_max, 0);
 	SetTimestep(timestep);
 
 	plot_file = Util::GetFileName();
@@ -142,6 +174,12 @@ Integrator::MakeNewLevelFromCoarse (int lev, amrex::Real time, const amrex::BoxA
 		m_basefields[n]->MakeNewLevelFromCoarse(lev,time,cgrids,dm);
 	}
 
+	DefineReflux(lev, cgrids, dm);
+	DefineCost(lev, cgrids, dm);
+
+	loadbalance.time[lev] = 0.0;
+	loadbalance.steps[lev] = 0;
+
 }
 
 
@@ -188,6 +226,12 @@ Integrator::RemakeLevel (int lev,       ///<[in] AMR Level
 	{
 		m_basefields[n]->RemakeLevel(lev,time,cgrids,dm);
 	}
+
+	DefineReflux(lev, cgrids, dm);
+	DefineCost(lev, cgrids, dm);
+
+	loadbalance.time[lev] = 0.0;
+	loadbalance.steps[lev] = 0;
 }
 
 //
@@ -207,6 +251,95 @@ Integrator::ClearLevel (int lev)
 	{
 		(*node.fab_array[n])[lev].reset(nullptr);
 	}
+	for (unsigned int n = 0; n < reflux.fields.size(); n++)
+	{
+		for (int d = 0; d < AMREX_SPACEDIM; d++) reflux.fields[n].flux[lev][d].reset(nullptr);
+		reflux.fields[n].reg[lev].reset(nullptr);
+	}
+	loadbalance.cost[lev].reset(nullptr);
+	loadbalance.measured[lev] = 0;
+}
+
+///
+/// Allocate the face fluxes of every field registered with RegisterFlux on level
+/// `lev`, and the flux register between `lev` and `lev-1`. Called whenever the
+/// grids on a level change.
+///
+/// The register holds the coarse and fine fluxes of the current coarse step
+/// of level `lev-1` until they are refluxed, so the level must not be remade
+/// in between (regrid and LoadBalance only remake levels at step boundaries).
+///
+void
+Integrator::DefineReflux (int lev, const amrex::BoxArray& cgrids, const amrex::DistributionMapping& dm)
+{
+	BL_PROFILE("Integrator::DefineReflux");
+	if (!reflux.on) return;
+	if (lev > 0 && reflux.pending[lev])
+		Util::Abort(INFO,"Level ",lev," remade while its flux register holds unrefluxed fluxes");
+	for (unsigned int n = 0; n < reflux.fields.size(); n++)
+	{
+		RefluxField &r = reflux.fields[n];
+		const int ncomp = (*r.field)[lev]->nComp();
+		for (int d = 0; d < AMREX_SPACEDIM; d++)
+		{
+			r.flux[lev][d].reset(new amrex::MultiFab(amrex::convert(cgrids, amrex::IntVect::TheDimensionVector(d)), dm, ncomp, 0));
+			r.flux[lev][d]->setVal(0.0);
+		}
+		if (lev > 0) r.reg[lev].reset(new amrex::FluxRegister(cgrids, dm, refRatio(lev-1), lev, ncomp));
+	}
+}
+
+///
+/// Allocate the measured cost of each box on level `lev`. When the level is
+/// remade, the cost recorded on the old boxes is carried over to the new boxes
+/// in proportion to their overlap, so that a regrid does not discard it.
+///
+void
+Integrator::DefineCost (int lev, const amrex::BoxArray& cgrids, const amrex::DistributionMapping& dm)
+{
+	BL_PROFILE("Integrator::DefineCost");
+	if (loadbalance.strategy == "none") return;
+
+	std::unique_ptr<amrex::LayoutData<Set::Scalar>> cost(new amrex::LayoutData<Set::Scalar>(cgrids, dm));
+	for (amrex::MFIter mfi(*cost); mfi.isValid(); ++mfi) (*cost)[mfi] = 0.0;
+
+	if (loadbalance.cost[lev])
+	{
+		const amrex::LayoutData<Set::Scalar> &old = *loadbalance.cost[lev];
+		const amrex::BoxArray &oldgrids = old.boxArray();
+		amrex::Vector<Set::Scalar> oldcost(oldgrids.size(), 0.0);
+		for (amrex::MFIter mfi(old); mfi.isValid(); ++mfi) oldcost[mfi.index()] = old[mfi];
+		amrex::ParallelDescriptor::ReduceRealSum(oldcost.dataPtr(), oldcost.size());
+
+		for (amrex::MFIter mfi(*cost); mfi.isValid(); ++mfi)
+			for (const auto &isect : oldgrids.intersections(cgrids[mfi.index()]))
+				(*cost)[mfi] += oldcost[isect.first] * (Set::Scalar)isect.second.numPts()
+					/ (Set::Scalar)oldgrids[isect.first].numPts();
+		amrex::ParallelDescriptor::ReduceIntMax(loadbalance.measured[lev]);
+	}
+	else loadbalance.measured[lev] = 0;
+
+	loadbalance.cost[lev] = std::move(cost);
+}
+
+///
+/// Spread `seconds`, spent outside of Advance in work that covers every level
+/// (e.g. the Newton/MLMG solves in TimeStepBegin), over the boxes on this
+/// processor in proportion to their number of cells.
+///
+void
+Integrator::DistributeCost (Set::Scalar seconds)
+{
+	BL_PROFILE("Integrator::DistributeCost");
+	if (loadbalance.strategy == "none") return;
+	Set::Scalar cells = 0.0;
+	for (int lev = 0; lev <= finest_level; lev++)
+		for (amrex::MFIter mfi(*loadbalance.cost[lev]); mfi.isValid(); ++mfi)
+			cells += (Set::Scalar)mfi.validbox().numPts();
+	if (cells <= 0.0) return;
+	for (int lev = 0; lev <= finest_level; lev++)
+		for (amrex::MFIter mfi(*loadbalance.cost[lev]); mfi.isValid(); ++mfi)
+			(*loadbalance.cost[lev])[mfi] += seconds * (Set::Scalar)mfi.validbox().numPts() / cells;
 }
 
 //
@@ -280,15 +413,46 @@ Integrator::RegisterNodalFab(Set::Field<Set::Scalar> &new_fab,
 }
 
 
+int // CUSTOM METHOD - CHANGEABLE
+Integrator::RegisterFlux(Set::Field<Set::Scalar> &field)
+{
+	BL_PROFILE("Integrator::RegisterFlux");
+	bool registered = false;
+	for (int n = 0; n < cell.number_of_fabs; n++) if (cell.fab_array[n] == &field) registered = true;
+	if (!registered) Util::Abort(INFO,"Only cell-based fields registered with RegisterNewFab can be refluxed");
+
+	RefluxField r;
+	r.field = &field;
+	r.flux.resize(maxLevel()+1);
+	r.reg.resize(maxLevel()+1);
+	reflux.fields.push_back(std::move(r));
+	return reflux.fields.size() - 1;
+}
+
 void // CUSTOM METHOD - CHANGEABLE
-Integrator::RegisterIntegratedVariable(Set::Scalar *integrated_variable, std::string name)
+Integrator::RegisterIntegratedVariable(Set::Scalar *integrated_variable, std::string name, bool extensive)
 {
 	BL_PROFILE("Integrator::RegisterIntegratedVariable");
 	thermo.vars.push_back(integrated_variable);
 	thermo.names.push_back(name);
+	thermo.extensives.push_back(extensive);
 	thermo.number++;
 }
 
+Set::Scalar & // CUSTOM METHOD - CHANGEABLE
+Integrator::Accumulator(Set::Scalar &integrated_variable)
+{
+	if (thermo.local.empty()) return integrated_variable;
+	int thread = 0;
+#ifdef _OPENMP
+	thread = omp_get_thread_num();
+#endif
+	for (int i = 0; i < thermo.number; i++)
+		if (thermo.vars[i] == &integrated_variable && thermo.extensives[i])
+			return thermo.local[thread][i];
+	return integrated_variable;
+}
+
 long // CUSTOM METHOD - CHANGEABLE
 Integrator::CountCells (int lev)
 {
@@ -404,6 +568,165 @@ Integrator::ErrorEst (int lev, amrex::TagBoxArray& tags, amrex::Real time, int n
 }
 
 
+void
+Integrator::RegisterRefinementCriterion (Set::Field<Set::Scalar> &field, Set::Scalar threshold,
+					 TagCriterion criterion, int scomp, int ncomp)
+{
+	BL_PROFILE("Integrator::RegisterRefinementCriterion");
+	RefinementCriterion crit;
+	crit.field = &field;
+	crit.threshold = threshold;
+	crit.criterion = criterion;
+	crit.scomp = scomp;
+	crit.ncomp = ncomp;
+	refinement_criteria.push_back(crit);
+}
+
+int
+Integrator::RegisterMultiRateGroup (std::vector<Set::Field<Set::Scalar>*> fields, int nsubsteps)
+{
+	BL_PROFILE("Integrator::RegisterMultiRateGroup");
+	if (nsubsteps < 1) Util::Abort(INFO,"nsubsteps must be at least 1 (got ",nsubsteps,")");
+	MultiRateGroup group;
+	group.nsubsteps = nsubsteps;
+	for (unsigned int f = 0; f < fields.size(); f++)
+	{
+		int n = 0;
+		while (n < cell.number_of_fabs && cell.fab_array[n] != fields[f]) n++;
+		if (n == cell.number_of_fabs) Util::Abort(INFO,"Multi-rate fields must first be registered with RegisterNewFab");
+		group.fabs.push_back(n);
+	}
+	multirate.push_back(group);
+	return multirate.size() - 1;
+}
+
+void
+Integrator::UpdateNarrowBand (int lev, std::vector<const Set::Field<Set::Scalar>*> fields,
+			      std::vector<const Set::Field<Set::Scalar>*> previous)
+{
+	BL_PROFILE("Integrator::UpdateNarrowBand");
+	if (!narrowband.on || fields.size() == 0) return;
+
+	const bool sweep = narrowband.sweep_int <= 0 || istep[lev] % narrowband.sweep_int == 0;
+	const Set::Scalar tol = narrowband.threshold;
+	std::vector<int> &active = narrowband.active[lev];
+	int nactive = 0, ntiles = 0;
+
+	// Sized outside the parallel region: under OpenMP, MFIter::length() counts one thread's tiles only
+	{
+		amrex::MFIter mfi(*(*fields[0])[lev], amrex::TilingIfNotGPU());
+		if (active.size() != (unsigned int)mfi.length()) active.resize(mfi.length());
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:nactive,ntiles)
+#endif
+	for (amrex::MFIter mfi(*(*fields[0])[lev], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		int &flag = active[mfi.LocalTileIndex()];
+		flag = sweep;
+
+		const amrex::Box &bx = mfi.tilebox();
+		const amrex::Box gbx = amrex::grow(bx,1);
+
+		// Is any field non-uniform near this tile?
+		for (unsigned int f = 0; f < fields.size() && !flag; f++)
+		{
+			const amrex::FArrayBox &fab = (*(*fields[f])[lev])[mfi];
+			for (int n = 0; n < fab.nComp() && !flag; n++)
+				if (fab.max(gbx,n) - fab.min(gbx,n) > tol) flag = 1;
+		}
+
+		// Did any field change in this tile during the last step?
+		for (unsigned int f = 0; f < previous.size() && !flag; f++)
+		{
+			amrex::Array4<const Set::Scalar> const &cur = (*(*fields[f])[lev]).array(mfi);
+			amrex::Array4<const Set::Scalar> const &prev = (*(*previous[f])[lev]).array(mfi);
+			const amrex::Dim3 lo = amrex::lbound(bx), hi = amrex::ubound(bx);
+			for (int n = 0; n < (*fields[f])[lev]->nComp() && !flag; n++)
+				for (int k = lo.z; k <= hi.z && !flag; k++)
+					for (int j = lo.y; j <= hi.y && !flag; j++)
+						for (int i = lo.x; i <= hi.x && !flag; i++)
+							if (std::fabs(cur(i,j,k,n) - prev(i,j,k,n)) > tol) flag = 1;
+		}
+
+		nactive += flag;
+		ntiles++;
+	}
+
+	if (Verbose() > 1)
+	{
+		amrex::ParallelDescriptor::ReduceIntSum(nactive);
+		amrex::ParallelDescriptor::ReduceIntSum(ntiles);
+		Util::Message(INFO,"Level ",lev,": ",nactive," of ",ntiles," tiles active",sweep ? " (full sweep)" : "");
+	}
+}
+
+///
+/// Evaluate all registered refinement criteria in one pass per tile.
+/// Thresholds are compared against squared norms so that no square
+/// roots are taken, and each cell stops as soon as one criterion is met.
+///
+void
+Integrator::TagCellsForRefinement (int lev, amrex::TagBoxArray& a_tags, amrex::Real /*time*/, int /*ngrow*/)
+{
+	BL_PROFILE("Integrator::TagCellsForRefinement");
+	const int ncrit = refinement_criteria.size();
+	if (ncrit == 0) return;
+
+	const amrex::Real *DX = geom[lev].CellSize();
+	const Set::Scalar dxnorm2 = Set::Vector(DX).squaredNorm();
+	const Set::Scalar dv = AMREX_D_TERM(DX[0],*DX[1],*DX[2]);
+
+	// Flatten the criteria into (field, component, threshold) triples. Both
+	// criteria reduce to a bound on the squared gradient.
+	amrex::Vector<int> crit_field, crit_comp;
+	amrex::Vector<Set::Scalar> crit_threshold;
+	for (int c = 0; c < ncrit; c++)
+	{
+		const RefinementCriterion &crit = refinement_criteria[c];
+		const int ncomp = crit.ncomp < 0 ? (*crit.field)[lev]->nComp() - crit.scomp : crit.ncomp;
+		for (int n = crit.scomp; n < crit.scomp + ncomp; n++)
+		{
+			crit_field.push_back(c);
+			crit_comp.push_back(n);
+			if (crit.criterion == TagCriterion::Gradient)
+				crit_threshold.push_back(crit.threshold*crit.threshold / dxnorm2);
+			else
+				crit_threshold.push_back(crit.threshold / dv);
+		}
+	}
+	const int nterms = crit_field.size();
+	const int *field = crit_field.dataPtr(), *comp = crit_comp.dataPtr();
+	const Set::Scalar *threshold = crit_threshold.dataPtr();
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+	{
+	amrex::Vector<amrex::Array4<const Set::Scalar>> data(ncrit);
+	for (amrex::MFIter mfi(a_tags, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		const amrex::Box &bx = mfi.tilebox();
+		amrex::Array4<char> const &tags = a_tags.array(mfi);
+		for (int c = 0; c < ncrit; c++) data[c] = (*(*refinement_criteria[c].field)[lev]).array(mfi);
+		const amrex::Array4<const Set::Scalar> *f = data.dataPtr();
+
+		amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+			for (int t = 0; t < nterms; t++)
+			{
+				Set::Vector grad = Numeric::Gradient(f[field[t]], i, j, k, comp[t], DX);
+				if (grad.squaredNorm() > threshold[t])
+				{
+					tags(i, j, k) = amrex::TagBox::SET;
+					return;
+				}
+			}
+		});
+	}
+	}
+}
+
 void
 Integrator::InitData ()
 {
@@ -429,6 +752,7 @@ Integrator::InitData ()
 			// for (int n = 0; n < node.number_of_fabs; n++)
 			// 	amrex::average_down_nodal(*(*node.fab_array[n])[lev+1], *(*node.fab_array[n])[lev], refRatio(lev));
 		}
+		if (initialization.uncovered_only) InitializeUncovered(time);
 		SetFinestLevel(finest_level);
 	
 	}
@@ -437,6 +761,88 @@ Integrator::InitData ()
 	}
 }
 
+///
+/// Evaluate the initial condition on levels 1 and finer, only on valid cells
+/// that are not covered by the next finer level, then average down so that
+/// covered cells are consistent with the finer data. Level 0 was already
+/// evaluated when the hierarchy was built.
+///
+/// Initialize(lev) is called with every registered cell fab temporarily
+/// replaced by a ghost-free MultiFab on the uncovered boxes (owned by the same
+/// ranks as their parent boxes), so initial conditions need no modification.
+/// Ghost cells are filled afterwards by the boundary conditions.
+///
+void
+Integrator::InitializeUncovered (amrex::Real time)
+{
+	BL_PROFILE("Integrator::InitializeUncovered");
+
+	for (int lev = 1; lev <= finest_level; lev++)
+	{
+		amrex::BoxList bl;
+		amrex::Vector<int> pmap;
+		amrex::BoxArray cfba;
+		if (lev < finest_level) cfba = amrex::coarsen(grids[lev+1], refRatio(lev));
+		for (int i = 0; i < grids[lev].size(); i++)
+		{
+			if (lev < finest_level)
+			{
+				const amrex::BoxArray comp = amrex::complementIn(grids[lev][i], cfba);
+				for (int b = 0; b < comp.size(); b++)
+				{
+					bl.push_back(comp[b]);
+					pmap.push_back(dmap[lev][i]);
+				}
+			}
+			else
+			{
+				bl.push_back(grids[lev][i]);
+				pmap.push_back(dmap[lev][i]);
+			}
+		}
+
+		if (bl.isEmpty())
+		{
+			// Fully covered: there is nothing to save, so initialize normally.
+			Initialize(lev);
+			continue;
+		}
+
+		const amrex::BoxArray ba(bl);
+		const amrex::DistributionMapping dm(pmap);
+
+		std::vector<std::unique_ptr<amrex::MultiFab>> full(cell.number_of_fabs);
+		for (int n = 0; n < cell.number_of_fabs; n++)
+		{
+			full[n] = std::move((*cell.fab_array[n])[lev]);
+			(*cell.fab_array[n])[lev].reset(new amrex::MultiFab(ba, dm, cell.ncomp_array[n], 0));
+			(*cell.fab_array[n])[lev]->setVal(0.0);
+		}
+
+		Initialize(lev);
+
+		for (int n = 0; n < cell.number_of_fabs; n++)
+		{
+			full[n]->ParallelCopy(*(*cell.fab_array[n])[lev], 0, 0, cell.ncomp_array[n]);
+			(*cell.fab_array[n])[lev] = std::move(full[n]);
+		}
+	}
+
+	for (int lev = finest_level-1; lev >= 0; --lev)
+		for (int n = 0; n < cell.number_of_fabs; n++)
+			amrex::average_down(*(*cell.fab_array[n])[lev+1], *(*cell.fab_array[n])[lev],
+					    geom[lev+1], geom[lev],
+					    0, (*cell.fab_array[n])[lev]->nComp(), refRatio(lev));
+
+	for (int lev = 0; lev <= finest_level; lev++)
+	{
+		for (int n = 0 ; n < cell.number_of_fabs; n++)
+			cell.physbc_array[n]->FillBoundary(*(*cell.fab_array[n])[lev],0,0,time,0);
+		for (int n = 0 ; n < node.number_of_fabs; n++)
+			node.physbc_array[n]->FillBoundary(*(*node.fab_array[n])[lev],0,0,time,0);
+	}
+}
+
 void
 Integrator::Restart(const std::string dirname)
 {
@@ -542,6 +948,7 @@ Integrator::Restart(const std::string dirname)
 				}
 			if (!match) Util::Warning(INFO,"Fab ",tmp_name_array[i]," is in the restart file, but there is no fab with that name here.");
 		}							
+		DefineReflux(lev, grids[lev], dmap[lev]);
 	}
 }
 
@@ -567,11 +974,22 @@ Integrator::MakeNewLevelFromScratch (int lev, amrex::Real t, const amrex::BoxArr
 	{
 		m_basefields[n]->MakeNewLevelFromScratch(lev,t,cgrids,dm);
 	}
+	DefineReflux(lev, cgrids, dm);
+	DefineCost(lev, cgrids, dm);
 
 	t_new[lev] = t;
 	t_old[lev] = t - dt[lev];
 
-	Initialize(lev);
+	// When only uncovered cells are to be evaluated, finer levels are interpolated
+	// here, and evaluated later in InitializeUncovered.
+	if (initialization.uncovered_only && lev > 0)
+	{
+		for (int n = 0 ; n < cell.number_of_fabs; n++)
+			FillCoarsePatch(lev, t, *cell.fab_array[n], *cell.physbc_array[n], 0, cell.ncomp_array[n]);
+		for (int n = 0 ; n < node.number_of_fabs; n++)
+			FillCoarsePatch(lev, t, *node.fab_array[n], *node.physbc_array[n], 0, node.ncomp_array[n]);
+	}
+	else Initialize(lev);
   
 	for (int n = 0 ; n < cell.number_of_fabs; n++)
 	{
@@ -637,44 +1055,32 @@ Integrator::WritePlotFile (Set::Scalar time, amrex::Vector<int> iter, bool initi
 			nnames.push_back(node.name_array[i]);
 	}
 
-	amrex::Vector<amrex::MultiFab> cplotmf(nlevels), nplotmf(nlevels);
-  
+	//
+	// The registered fabs are handed to the writer as-is (no packed copy),
+	// so output does not increase the memory footprint.
+	//
+	amrex::Vector<amrex::Vector<const amrex::MultiFab*>> cfields(nlevels), nfields(nlevels);
+
 	for (int ilev = 0; ilev < nlevels; ++ilev)
 	{
-		if (ccomponents > 0)
+		for (int i = 0; i < cell.number_of_fabs; i++)
 		{
-			cplotmf[ilev].define(grids[ilev], dmap[ilev], ccomponents, 0);
-
-			int n = 0;
-			for (int i = 0; i < cell.number_of_fabs; i++)
-			{
-				if (!cell.writeout_array[i]) continue;
-				if ((*cell.fab_array[i])[ilev]->contains_nan()) Util::Abort(INFO,cnames[i]," contains nan (i=",i,")");
-				if ((*cell.fab_array[i])[ilev]->contains_inf()) Util::Abort(INFO,cnames[i]," contains inf (i=",i,")");
-				amrex::MultiFab::Copy(cplotmf[ilev], *(*cell.fab_array[i])[ilev], 0, n, cell.ncomp_array[i], 0);
-				n += cell.ncomp_array[i];
-			}
+			if (!cell.writeout_array[i]) continue;
+			if ((*cell.fab_array[i])[ilev]->contains_nan()) Util::Abort(INFO,cell.name_array[i]," contains nan (i=",i,")");
+			if ((*cell.fab_array[i])[ilev]->contains_inf()) Util::Abort(INFO,cell.name_array[i]," contains inf (i=",i,")");
+			cfields[ilev].push_back((*cell.fab_array[i])[ilev].get());
 		}
 
-		if (ncomponents > 0)
+		for (int i = 0; i < node.number_of_fabs; i++)
 		{
-			amrex::BoxArray ngrids = grids[ilev];
-			ngrids.convert(amrex::IntVect::TheNodeVector());
-			nplotmf[ilev].define(ngrids, dmap[ilev], ncomponents, 0);
-			
-			int n = 0;
-			for (int i = 0; i < node.number_of_fabs; i++)
+			if (!node.writeout_array[i]) continue;
+			if ((*node.fab_array[i])[ilev]->contains_nan()) 
 			{
-				if (!node.writeout_array[i]) continue;
-				if ((*node.fab_array[i])[ilev]->contains_nan()) 
-				{
-					Util::Warning(INFO,nnames[i]," contains nan (i=",i,"). Resetting to zero.");
-					(*node.fab_array[i])[ilev]->setVal(0.0);
-				}
-				if ((*node.fab_array[i])[ilev]->contains_inf()) Util::Abort(INFO,nnames[i]," contains inf (i=",i,")");
-				amrex::MultiFab::Copy(nplotmf[ilev], *(*node.fab_array[i])[ilev], 0, n, node.ncomp_array[i], 0);
-				n += node.ncomp_array[i];
+				Util::Warning(INFO,node.name_array[i]," contains nan (i=",i,"). Resetting to zero.");
+				(*node.fab_array[i])[ilev]->setVal(0.0);
 			}
+			if ((*node.fab_array[i])[ilev]->contains_inf()) Util::Abort(INFO,node.name_array[i]," contains inf (i=",i,")");
+			nfields[ilev].push_back((*node.fab_array[i])[ilev].get());
 		}
 	}
 
@@ -683,8 +1089,8 @@ Integrator::WritePlotFile (Set::Scalar time, amrex::Vector<int> iter, bool initi
   
 	if (ccomponents > 0)
 	{
-		WriteMultiLevelPlotfile(plotfilename[0]+plotfilename[1]+"cell", nlevels, amrex::GetVecOfConstPtrs(cplotmf), cnames,
-					Geom(), time, iter, refRatio());
+		IO::WriteFields(plotfilename[0]+plotfilename[1]+"cell", nlevels, cfields, cnames,
+				Geom(), time, iter, refRatio());
 	
 		std::ofstream chkptfile;
 		chkptfile.open(plotfilename[0]+plotfilename[1]+"cell/Checkpoint");
@@ -694,8 +1100,8 @@ Integrator::WritePlotFile (Set::Scalar time, amrex::Vector<int> iter, bool initi
 
 	if (ncomponents > 0)
 	{
-		WriteMultiLevelPlotfile(plotfilename[0]+plotfilename[1]+"node", nlevels, amrex::GetVecOfConstPtrs(nplotmf), nnames,
-					Geom(), time, iter, refRatio());
+		IO::WriteFields(plotfilename[0]+plotfilename[1]+"node", nlevels, nfields, nnames,
+				Geom(), time, iter, refRatio());
 	}
 
 	if (amrex::ParallelDescriptor::IOProcessor())
@@ -730,7 +1136,9 @@ Integrator::Evolve ()
 		}
 		int lev = 0;
 		int iteration = 1;
+		Set::Scalar begin_start = amrex::second();
 		TimeStepBegin(cur_time,step);
+		DistributeCost(amrex::second() - begin_start);
 		IntegrateVariables(cur_time,step);
 		TimeStep(lev, cur_time, iteration);
 		TimeStepComplete(cur_time,step);
@@ -776,33 +1184,38 @@ Integrator::IntegrateVariables (amrex::Real time, int step)
 		 ((thermo.dt > 0.0) && (std::fabs(std::remainder(time,plot_dt)) < 0.5*dt[0])) )
 	{
 		// Zero out all variables
-		for (int i = 0; i < thermo.number; i++) *thermo.vars[i] = 0; 
+		for (int i = 0; i < thermo.number; i++) if (thermo.extensives[i]) *thermo.vars[i] = 0; 
 
-		// All levels except the finest
-		for (int ilev = 0; ilev < max_level; ilev++)
-		{
-			const amrex::BoxArray& cfba = amrex::coarsen(grids[ilev+1], refRatio(ilev));
+		// Each thread accumulates into its own copy of the extensive variables
+		// (see Accumulator); the copies are summed once the tiles are done.
+		int nthreads = 1;
+#ifdef _OPENMP
+		nthreads = omp_get_max_threads();
+#endif
+		thermo.local.assign(nthreads, std::vector<Set::Scalar>(thermo.number, 0.0));
 
-#ifdef OMP
-			#pragma omp parallel
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-			for ( amrex::MFIter mfi(grids[ilev],dmap[ilev],true); mfi.isValid(); ++mfi )
+		{
+			// All levels except the finest
+			for (int ilev = 0; ilev < max_level; ilev++)
 			{
-				const amrex::Box& box = mfi.tilebox();
-				const amrex::BoxArray & comp = amrex::complementIn(box,cfba);
+				const amrex::BoxArray& cfba = amrex::coarsen(grids[ilev+1], refRatio(ilev));
 
-				for (int i = 0; i < comp.size(); i++)
+				for ( amrex::MFIter mfi(grids[ilev],dmap[ilev],true); mfi.isValid(); ++mfi )
 				{
-					Integrate(ilev,time, step,
-						  mfi, comp[i]);
+					const amrex::Box& box = mfi.tilebox();
+					const amrex::BoxArray & comp = amrex::complementIn(box,cfba);
+
+					for (int i = 0; i < comp.size(); i++)
+					{
+						Integrate(ilev,time, step,
+							  mfi, comp[i]);
+					}
 				}
 			}
-		}
-		// Now do the finest level
-		{
-			#ifdef OMP
-			#pragma omp parallel
-			#endif 
+			// Now do the finest level
 			for ( amrex::MFIter mfi(grids[max_level],dmap[max_level],true); mfi.isValid(); ++mfi )
 			{
 				const amrex::Box& box = mfi.tilebox();
@@ -810,9 +1223,15 @@ Integrator::IntegrateVariables (amrex::Real time, int step)
 			}
 		}
 
+		for (unsigned int t = 0; t < thermo.local.size(); t++)
+			for (int i = 0; i < thermo.number; i++)
+				if (thermo.extensives[i]) *thermo.vars[i] += thermo.local[t][i];
+		thermo.local.clear();
+
 		// Sum up across all processors
 		for (int i = 0; i < thermo.number; i++) 
 		{
+			if (!thermo.extensives[i]) continue;
 			amrex::ParallelDescriptor::ReduceRealSum(*thermo.vars[i]);
 		}
 	}
@@ -842,6 +1261,77 @@ Integrator::IntegrateVariables (amrex::Real time, int step)
 }
 
 
+///
+/// Redistribute the boxes on level `lev` among processors using the
+/// measured cost of each box: the time recorded with AddCost if the
+/// integrator measures its boxes, otherwise the time spent in Advance on
+/// each processor weighted by Cost(); plus the box's share of the time
+/// spent in TimeStepBegin. The new mapping is only used if it improves the efficiency
+/// (average cost / maximum cost per processor) by more than
+/// `loadbalance.threshold`.
+///
+void
+Integrator::LoadBalance (int lev, amrex::Real time)
+{
+	BL_PROFILE("Integrator::LoadBalance");
+	const int nboxes = grids[lev].size();
+	const int nprocs = amrex::ParallelDescriptor::NProcs();
+	if (nprocs == 1) return;
+
+	amrex::LayoutData<Set::Scalar> &boxcost = *loadbalance.cost[lev];
+	amrex::ParallelDescriptor::ReduceIntMax(loadbalance.measured[lev]);
+
+	// measured and steps are the same on every processor, so either all use
+	// measured times or none do
+	amrex::Vector<amrex::Real> cost(nboxes, 0.0);
+	if (loadbalance.measured[lev])
+	{
+		for (amrex::MFIter mfi(boxcost); mfi.isValid(); ++mfi)
+			cost[mfi.index()] = boxcost[mfi];
+	}
+	else
+	{
+		Set::Scalar weight = 0.0;
+		for (amrex::MFIter mfi(grids[lev],dmap[lev]); mfi.isValid(); ++mfi)
+		{
+			cost[mfi.index()] = Cost(lev, mfi);
+			weight += cost[mfi.index()];
+		}
+		if (loadbalance.steps[lev] > 0 && weight > 0.0)
+			for (amrex::MFIter mfi(grids[lev],dmap[lev]); mfi.isValid(); ++mfi)
+				cost[mfi.index()] = cost[mfi.index()] * loadbalance.time[lev] / weight + boxcost[mfi];
+	}
+	amrex::ParallelDescriptor::ReduceRealSum(cost.dataPtr(), nboxes);
+
+	for (amrex::MFIter mfi(boxcost); mfi.isValid(); ++mfi) boxcost[mfi] = 0.0;
+	loadbalance.measured[lev] = 0;
+	loadbalance.time[lev] = 0.0;
+	loadbalance.steps[lev] = 0;
+
+	amrex::Vector<amrex::Real> proccost(nprocs, 0.0);
+	for (int i = 0; i < nboxes; i++) proccost[dmap[lev][i]] += cost[i];
+	amrex::Real maxcost = *std::max_element(proccost.begin(), proccost.end());
+	if (maxcost <= 0.0) return;
+	amrex::Real efficiency = std::accumulate(proccost.begin(), proccost.end(), 0.0) / (nprocs * maxcost);
+
+	amrex::Real new_efficiency = 0.0;
+	amrex::DistributionMapping new_dmap;
+	if (loadbalance.strategy == "knapsack")
+		new_dmap = amrex::DistributionMapping::makeKnapSack(cost, new_efficiency);
+	else if (loadbalance.strategy == "sfc")
+		new_dmap = amrex::DistributionMapping::makeSFC(cost, grids[lev], new_efficiency);
+
+	if (Verbose())
+		Util::Message(INFO,"Level ",lev,": efficiency = ",efficiency,", proposed (",loadbalance.strategy,") = ",new_efficiency);
+
+	if (new_efficiency > (1.0 + loadbalance.threshold)*efficiency)
+	{
+		RemakeLevel(lev, time, grids[lev], new_dmap);
+		SetDistributionMap(lev, new_dmap);
+		SetFinestLevel(finest_level);
+	}
+}
+
 void
 Integrator::TimeStep (int lev, amrex::Real time, int /*iteration*/)
 {
@@ -861,6 +1351,14 @@ Integrator::TimeStep (int lev, amrex::Real time, int /*iteration*/)
 	}
 	SetFinestLevel(finest_level);
 
+	// Fine levels are only rebalanced here, at the start of a coarse step, when every
+	// level is synchronized. Remaking a fine level between its substeps would discard
+	// the flux register data accumulated so far.
+	if (lev == 0 && loadbalance.strategy != "none" && loadbalance.interval > 0 &&
+	    istep[0] > 0 && istep[0] % loadbalance.interval == 0)
+		for (int ilev = 0; ilev <= finest_level; ilev++)
+			LoadBalance(ilev, time);
+
 	if (Verbose() && amrex::ParallelDescriptor::IOProcessor()) {
 		std::cout << "[Level " << lev 
 			  << " step " << istep[lev]+1 << "] ";
@@ -874,9 +1372,57 @@ Integrator::TimeStep (int lev, amrex::Real time, int /*iteration*/)
 	for (int n = 0 ; n < node.number_of_fabs ; n++)
 		FillPatch(lev,time,*node.fab_array[n],*(*node.fab_array[n])[lev],*node.physbc_array[n],0);
 
+	if (reflux.on)
+		for (unsigned int n = 0; n < reflux.fields.size(); n++)
+		{
+			for (int d = 0; d < AMREX_SPACEDIM; d++) reflux.fields[n].flux[lev][d]->setVal(0.0);
+			if (lev < finest_level) reflux.fields[n].reg[lev+1]->setVal(0.0);
+		}
+	if (reflux.on && lev < finest_level) reflux.pending[lev+1] = 1;
+
+	// Only the integrator's own work is timed, not the FillPatch communication
+	amrex::Real advance_time = 0.0;
+	for (unsigned int g = 0; g < multirate.size(); g++)
+	{
+		const int nsub = multirate[g].nsubsteps;
+		const amrex::Real subdt = dt[lev] / (amrex::Real)nsub;
+		for (int s = 0; s < nsub; s++)
+		{
+			if (s > 0) // the first substep was filled above along with everything else
+				for (unsigned int f = 0; f < multirate[g].fabs.size(); f++)
+				{
+					const int n = multirate[g].fabs[f];
+					FillPatch(lev,time + s*subdt,*cell.fab_array[n],*(*cell.fab_array[n])[lev],*cell.physbc_array[n],0);
+				}
+			const amrex::Real substep_start = amrex::second();
+			AdvanceSubstep(lev, time + s*subdt, subdt, g);
+			advance_time += amrex::second() - substep_start;
+		}
+	}
+	const amrex::Real advance_start = amrex::second();
 	Advance(lev, time, dt[lev]);
+	advance_time += amrex::second() - advance_start;
+	loadbalance.time[lev] += advance_time;
+	loadbalance.steps[lev]++;
 	++istep[lev];
 
+	// The coarse side of the register is overwritten once per coarse step; the fine
+	// side accumulates over all of the fine substeps. Fluxes are already multiplied
+	// by dt, so only the face area is applied here.
+	if (reflux.on)
+		for (unsigned int n = 0; n < reflux.fields.size(); n++)
+		{
+			RefluxField &r = reflux.fields[n];
+			const int ncomp = (*r.field)[lev]->nComp();
+			for (int d = 0; d < AMREX_SPACEDIM; d++)
+			{
+				Set::Scalar area = 1.0;
+				for (int d2 = 0; d2 < AMREX_SPACEDIM; d2++) if (d2 != d) area *= geom[lev].CellSize(d2);
+				if (lev < finest_level) r.reg[lev+1]->CrseInit(*r.flux[lev][d], d, 0, 0, ncomp, -area);
+				if (lev > 0)            r.reg[lev]->FineAdd(*r.flux[lev][d], d, 0, 0, ncomp, area);
+			}
+		}
+
 	if (Verbose() && amrex::ParallelDescriptor::IOProcessor())
 	{
 		std::cout << "[Level " << lev
@@ -892,6 +1438,14 @@ Integrator::TimeStep (int lev, amrex::Real time, int /*iteration*/)
 		for (int i = 1; i <= nsubsteps[lev+1]; ++i)
 			TimeStep(lev+1, time+(i-1)*dt[lev+1], i);
 
+		if (reflux.on)
+			for (unsigned int n = 0; n < reflux.fields.size(); n++)
+			{
+				RefluxField &r = reflux.fields[n];
+				r.reg[lev+1]->Reflux(*(*r.field)[lev], 1.0, 0, 0, (*r.field)[lev]->nComp(), geom[lev]);
+			}
+		if (reflux.on) reflux.pending[lev+1] = 0;
+
 		for (int n = 0; n < cell.number_of_fabs; n++)
 		{
 			amrex::average_down(*(*cell.fab_array[n])[lev+1], *(*cell.fab_array[n])[lev],
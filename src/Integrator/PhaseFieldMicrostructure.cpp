@@ -146,6 +146,11 @@ PhaseFieldMicrostructure::PhaseFieldMicrostructure() : Integrator()
 		}
 		else if (ic_type == "sphere")
 			ic = new IC::Sphere(geom);
+		else if (ic_type == "voxel")
+		{
+			ic = new IC::Voxel(geom);
+			pp.queryclass("voxel",*static_cast<IC::Voxel*>(ic));
+		}
 		else
 			Util::Abort(INFO, "No valid initial condition specified");
 	}
@@ -153,6 +158,7 @@ PhaseFieldMicrostructure::PhaseFieldMicrostructure() : Integrator()
 	eta_new_mf.resize(maxLevel() + 1);
 	RegisterNewFab(eta_new_mf, mybc, number_of_grains, number_of_ghost_cells, "Eta",true);
 	RegisterNewFab(eta_old_mf, mybc, number_of_grains, number_of_ghost_cells, "Eta old",false);
+	RegisterRefinementCriterion(eta_new_mf, ref_threshold);
 
 	volume = 1.0;
 	RegisterIntegratedVariable(&volume, "volume");
@@ -210,11 +216,45 @@ void PhaseFieldMicrostructure::Advance(int lev, amrex::Real time, amrex::Real dt
 
 	Model::Interface::GB::SH gbmodel(0.0, 0.0, anisotropy.sigma0, anisotropy.sigma1);
 
+	UpdateNarrowBand(lev, {&eta_old_mf}, {&eta_new_mf});
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 	for (amrex::MFIter mfi(*eta_new_mf[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
 	{
+		const amrex::Real tile_start = amrex::second();
 		const amrex::Box &bx = mfi.tilebox();
+		if (!NarrowBandActive(lev, mfi))
+		{
+			(*eta_new_mf[lev])[mfi].copy((*eta_old_mf[lev])[mfi], bx);
+			AddCost(lev, mfi, amrex::second() - tile_start);
+			continue;
+		}
 		amrex::Array4<const amrex::Real> const &eta = (*eta_old_mf[lev]).array(mfi);
 		amrex::Array4<amrex::Real> const &etanew = (*eta_new_mf[lev]).array(mfi);
+
+#if AMREX_SPACEDIM == 2
+		// Boundary energy and its derivatives for every (cell, grain) of the tile,
+		// computed with one call to the GB model instead of one per cell.
+		// Components [0,N), [N,2N), [2N,3N) of wfab hold W, DW and DDW.
+		amrex::FArrayBox thetafab, wfab;
+		if (anisotropy.on && time >= anisotropy.tstart)
+		{
+			thetafab.resize(bx, number_of_grains);
+			wfab.resize(bx, 3*number_of_grains);
+			amrex::Array4<Set::Scalar> const &th = thetafab.array();
+			amrex::ParallelFor(bx, number_of_grains, [=] AMREX_GPU_DEVICE(int i, int j, int k, int m) {
+				Set::Vector Deta = Numeric::Gradient(eta, i, j, k, m, DX);
+				th(i,j,k,m) = atan2(Deta(1),Deta(0));
+			});
+			const int n = (int)bx.numPts()*number_of_grains;
+			boundary->Evaluate(n, thetafab.dataPtr(), wfab.dataPtr(0),
+					   wfab.dataPtr(number_of_grains), wfab.dataPtr(2*number_of_grains));
+		}
+		amrex::Array4<const Set::Scalar> const &theta = thetafab.const_array();
+		amrex::Array4<const Set::Scalar> const &wtab = wfab.const_array();
+#endif
 		
 		amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
 			for (int m = 0; m < number_of_grains; m++)
@@ -250,11 +290,14 @@ void PhaseFieldMicrostructure::Advance(int lev, amrex::Real time, amrex::Real dt
 					Util::Abort(INFO, "Anisotropy is enabled but works in 2D/3D ONLY");
 #elif AMREX_SPACEDIM == 2
 						Set::Vector tangent(normal[1],-normal[0]);
-						Set::Scalar Theta = atan2(Deta(1),Deta(0));
-						Set::Scalar kappa = pf.l_gb*0.75*boundary->W(Theta);
-						Set::Scalar Dkappa = pf.l_gb*0.75*boundary->DW(Theta);
-						Set::Scalar DDkappa = pf.l_gb*0.75*boundary->DDW(Theta);
-						mu = 0.75 * (1.0/0.23) * boundary->W(Theta) / pf.l_gb;
+						Set::Scalar Theta = theta(i,j,k,m);
+						Set::Scalar W   = wtab(i,j,k,m);
+						Set::Scalar DW  = wtab(i,j,k,number_of_grains + m);
+						Set::Scalar DDW = wtab(i,j,k,2*number_of_grains + m);
+						Set::Scalar kappa = pf.l_gb*0.75*W;
+						Set::Scalar Dkappa = pf.l_gb*0.75*DW;
+						Set::Scalar DDkappa = pf.l_gb*0.75*DDW;
+						mu = 0.75 * (1.0/0.23) * W / pf.l_gb;
 						Set::Scalar sinTheta = sin(Theta);
 						Set::Scalar cosTheta = cos(Theta);
 			
@@ -449,6 +492,7 @@ void PhaseFieldMicrostructure::Advance(int lev, amrex::Real time, amrex::Real dt
 			});
 
 		}
+		AddCost(lev, mfi, amrex::second() - tile_start);
 	}
 }
 
@@ -469,27 +513,23 @@ void PhaseFieldMicrostructure::Initialize(int lev)
 	}
 }
 
-void PhaseFieldMicrostructure::TagCellsForRefinement(int lev, amrex::TagBoxArray &a_tags, amrex::Real /*time*/, int /*ngrow*/)
+Set::Scalar PhaseFieldMicrostructure::Cost(int lev, const amrex::MFIter &mfi)
 {
-	BL_PROFILE("PhaseFieldMicrostructure::TagCellsForRefinement");
+	BL_PROFILE("PhaseFieldMicrostructure::Cost");
+	// Advance skips a grain in a cell when |grad eta| < 1E-4, so the cost of a
+	// box is dominated by the (grain, cell) pairs that pass the same test.
+	const amrex::Box &bx = mfi.validbox();
+	amrex::Array4<const Set::Scalar> const &eta = (*eta_new_mf[lev]).array(mfi);
 	const amrex::Real *DX = geom[lev].CellSize();
-	const Set::Vector dx(DX);
-	const Set::Scalar dxnorm = dx.lpNorm<2>();
-
-	for (amrex::MFIter mfi(*eta_new_mf[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-	{
-		const amrex::Box &bx = mfi.tilebox();
-		amrex::Array4<const amrex::Real> const &etanew = (*eta_new_mf[lev]).array(mfi);
-		amrex::Array4<char> const &tags = a_tags.array(mfi);
-
-		for (int n = 0; n < number_of_grains; n++)
-			amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-				Set::Vector grad = Numeric::Gradient(etanew, i, j, k, n, DX);
-
-				if (dxnorm * grad.lpNorm<2>() > ref_threshold)
-					tags(i, j, k) = amrex::TagBox::SET;
-			});
-	}
+	const amrex::Dim3 lo = amrex::lbound(bx), hi = amrex::ubound(bx);
+
+	Set::Scalar cost = (Set::Scalar)bx.numPts();
+	for (int n = 0; n < number_of_grains; n++)
+		for (int k = lo.z; k <= hi.z; k++)
+			for (int j = lo.y; j <= hi.y; j++)
+				for (int i = lo.x; i <= hi.x; i++)
+					if (Numeric::Gradient(eta, i, j, k, n, DX).lpNorm<2>() >= 1E-4) cost += 1.0;
+	return cost;
 }
 
 void PhaseFieldMicrostructure::TimeStepComplete(amrex::Real /*time*/, int /*iter*/)
@@ -533,7 +573,10 @@ void PhaseFieldMicrostructure::TimeStepBegin(amrex::Real time, int iter)
 
 		Set::Vector DX(geom[lev].CellSize());
 
-		for (MFIter mfi(*model_mf[lev], false); mfi.isValid(); ++mfi)
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+		for (MFIter mfi(*model_mf[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
 		{
 		        amrex::Box bx = mfi.grownnodaltilebox();//-1,2);
 
@@ -572,9 +615,14 @@ void PhaseFieldMicrostructure::Integrate(int amrlev, Set::Scalar time, int /*ste
 
 	BL_PROFILE("PhaseFieldMicrostructure::Integrate");
 	amrex::Array4<amrex::Real> const &eta = (*eta_new_mf[amrlev]).array(mfi);
-	amrex::ParallelFor(box, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+	Set::Scalar &volume_sum       = Accumulator(volume);
+	Set::Scalar &area_sum         = Accumulator(area);
+	Set::Scalar &gbenergy_sum     = Accumulator(gbenergy);
+	Set::Scalar &realgbenergy_sum = Accumulator(realgbenergy);
+	Set::Scalar &regenergy_sum    = Accumulator(regenergy);
+	amrex::ParallelFor(box, [&](int i, int j, int k) {
 
-		volume += eta(i, j, k, 0) * dv;
+		volume_sum += eta(i, j, k, 0) * dv;
 
 		Set::Vector grad = Numeric::Gradient(eta, i, j, k, 0, DX);
 		Set::Scalar normgrad = grad.lpNorm<2>();
@@ -584,32 +632,32 @@ void PhaseFieldMicrostructure::Integrate(int amrlev, Set::Scalar time, int /*ste
 			Set::Vector normal = grad / normgrad;
 
 			Set::Scalar da = normgrad * dv;
-			area += da;
+			area_sum += da;
 
 			if (!anisotropy.on || time < anisotropy.tstart)
 			{
-				gbenergy += pf.sigma0 * da;
+				gbenergy_sum += pf.sigma0 * da;
 
 				Set::Scalar k = 0.75 * pf.sigma0 * pf.l_gb;
-				realgbenergy += 0.5 * k * normgrad * normgrad * dv;
-				regenergy = 0.0;
+				realgbenergy_sum += 0.5 * k * normgrad * normgrad * dv;
+				regenergy_sum = 0.0;
 			}
 			else
 			{
 #if AMREX_SPACEDIM == 2
 				Set::Scalar theta = atan2(grad(1), grad(0));
 				Set::Scalar sigma = boundary->W(theta);
-				gbenergy += sigma * da;
+				gbenergy_sum += sigma * da;
 
 				Set::Scalar k = 0.75 * sigma * pf.l_gb;
-				realgbenergy += 0.5 * k * normgrad * normgrad * dv;
+				realgbenergy_sum += 0.5 * k * normgrad * normgrad * dv;
 
 				Set::Matrix DDeta = Numeric::Hessian(eta, i, j, k, 0, DX);
 				Set::Vector tangent(normal[1], -normal[0]);
 				Set::Scalar k2 = (DDeta * tangent).dot(tangent);
-				regenergy += 0.5 * anisotropy.beta * k2 * k2;
+				regenergy_sum += 0.5 * anisotropy.beta * k2 * k2;
 #elif AMREX_SPACEDIM == 3
-				gbenergy += gbmodel.W(normal) * da;
+				gbenergy_sum += gbmodel.W(normal) * da;
 #endif
 			}
 		}
@@ -619,14 +667,17 @@ void PhaseFieldMicrostructure::Integrate(int amrlev, Set::Scalar time, int /*ste
 		amrex::Array4<amrex::Real> const &w        = (*energy_mf[amrlev]).array(mfi);
 		amrex::Array4<amrex::Real> const &stress   = (*stress_mf[amrlev]).array(mfi);
 		amrex::Array4<amrex::Real> const &u        = (*disp_mf[amrlev])  .array(mfi);
-		amrex::ParallelFor(box, [=] AMREX_GPU_DEVICE(int i, int j, int k) 
+		Set::Scalar &force_sum        = Accumulator(elastic.force);
+		Set::Scalar &disp_sum         = Accumulator(elastic.disp);
+		Set::Scalar &strainenergy_sum = Accumulator(elastic.strainenergy);
+		amrex::ParallelFor(box, [&](int i, int j, int k) 
 		{
 			if (j == geom[amrlev].Domain().hiVect()[1])
 			{
-				elastic.force += 0.5*(stress(i,j+1,k,1) + stress(i+1,j+1,k,1)) * DX[0];
-				elastic.disp  += 0.5*(u(i,j+1,k,0)      + u(i+1,j+1,k,0)     ) * DX[0];
+				force_sum += 0.5*(stress(i,j+1,k,1) + stress(i+1,j+1,k,1)) * DX[0];
+				disp_sum  += 0.5*(u(i,j+1,k,0)      + u(i+1,j+1,k,0)     ) * DX[0];
 			}
-			elastic.strainenergy += 0.25 * (w(i,j,k) + w(i+1,j,k) + w(i,j+1,k) + w(i+1,j+1,k)) * volume;
+			strainenergy_sum += 0.25 * (w(i,j,k) + w(i+1,j,k) + w(i,j+1,k) + w(i+1,j+1,k)) * dv;
 		});
 	}
 }
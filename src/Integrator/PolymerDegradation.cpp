@@ -21,6 +21,7 @@ PolymerDegradation::PolymerDegradation():
 	{
 		pp_water.query("diffusivity", water.diffusivity);
 		pp_water.query("refinement_threshold", water.refinement_threshold);
+		pp_water.query("nsubsteps", water.nsubsteps);
 		pp_water.query("ic_type", water.ic_type);
 
 		// // Determine initial condition
@@ -39,6 +40,9 @@ PolymerDegradation::PolymerDegradation():
 
 		RegisterNewFab(water_conc,     water.bc, 1, number_of_ghost_cells, "Water Concentration",true);
 		RegisterNewFab(water_conc_old, water.bc, 1, number_of_ghost_cells, "Water Concentration Old",false);
+		RegisterRefinementCriterion(water_conc, water.refinement_threshold);
+		water.group = RegisterMultiRateGroup({&water_conc, &water_conc_old}, water.nsubsteps);
+		water.flux = RegisterFlux(water_conc);
 	}
 
 	Util::Message(INFO);
@@ -51,6 +55,7 @@ PolymerDegradation::PolymerDegradation():
 	{
 		pp_heat.query("diffusivity", thermal.diffusivity);
 		pp_heat.query("refinement_threshold",thermal.refinement_threshold);
+		pp_heat.query("nsubsteps",thermal.nsubsteps);
 		pp_heat.query("ic_type",thermal.ic_type);
 
 		if (thermal.ic_type == "constant")
@@ -71,6 +76,8 @@ PolymerDegradation::PolymerDegradation():
 
 	RegisterNewFab(Temp,     thermal.bc, 1, number_of_ghost_cells, "Temperature",true);
 	RegisterNewFab(Temp_old, thermal.bc, 1, number_of_ghost_cells, "Temperature Old",false);
+	if (thermal.on) RegisterRefinementCriterion(Temp, thermal.refinement_threshold);
+	if (thermal.on) thermal.group = RegisterMultiRateGroup({&Temp, &Temp_old}, thermal.nsubsteps);
 
 	// ---------------------------------------------------------------------
 	// --------------------- Material model --------------------------------
@@ -192,6 +199,7 @@ PolymerDegradation::PolymerDegradation():
 	RegisterNewFab(eta_new, damage.bc, damage.number_of_eta, number_of_ghost_cells, "Eta",true);
 	RegisterNewFab(eta_old, damage.bc, damage.number_of_eta, number_of_ghost_cells, "Eta old",true);
 	RegisterNewFab(damage_start_time,damage.bc_time,1,number_of_ghost_cells,"Start time",true);
+	RegisterRefinementCriterion(eta_new, damage.refinement_threshold, TagCriterion::Gradient, 0, 1);
 
 	Util::Message(INFO);
 	// ---------------------------------------------------------------------
@@ -214,6 +222,11 @@ PolymerDegradation::PolymerDegradation():
 		pp_elastic.query("use_fsmooth",		elastic.use_fsmooth);
 		pp_elastic.query("agglomeration", 	elastic.agglomeration);
 		pp_elastic.query("consolidation", 	elastic.consolidation);
+		pp_elastic.query("galerkin",		elastic.galerkin);
+		pp_elastic.query("mixed_precision",	elastic.mixed_precision);
+		pp_elastic.query("smoother",		elastic.smoother);
+		pp_elastic.query("chebyshev_degree", elastic.chebyshev_degree);
+		pp_elastic.query("krylov",			elastic.krylov);
 
 		pp_elastic.query("bottom_solver",elastic.bottom_solver);
 		pp_elastic.query("linop_maxorder", elastic.linop_maxorder);
@@ -305,30 +318,29 @@ PolymerDegradation::PolymerDegradation():
 }
 
 
+///
+/// Water and thermal diffusion are advanced here, with their own
+/// (smaller) timesteps set by water.nsubsteps and thermal.nsubsteps.
+///
 void
-PolymerDegradation::Advance (int lev, amrex::Real time, amrex::Real dt)
+PolymerDegradation::AdvanceSubstep (int lev, amrex::Real time, amrex::Real dt, int group)
 {
-	Util::Message(INFO, "Enter");
-	std::swap(*eta_old[lev], 	*eta_new[lev]);
-	//	if (elastic.on) if (rhs[lev]->contains_nan()) Util::Abort(INFO);
-
-	if(water.on) std::swap(*water_conc_old[lev],*water_conc[lev]);
-	if(thermal.on) std::swap(*Temp_old[lev], *Temp[lev]);
-
-	static amrex::IntVect AMREX_D_DECL(	dx(AMREX_D_DECL(1,0,0)),
-						dy(AMREX_D_DECL(0,1,0)),
-						dz(AMREX_D_DECL(0,0,1)));
+	BL_PROFILE("PolymerDegradation::AdvanceSubstep");
 	const amrex::Real* DX = geom[lev].CellSize();
 
-	if(water.on)
+	if(water.on && group == water.group)
 	{
-		Util::Message(INFO);
-		for ( amrex::MFIter mfi(*water_conc[lev],true); mfi.isValid(); ++mfi )
+		std::swap(*water_conc_old[lev],*water_conc[lev]);
+
+		// Check and clamp the old concentration before any stencil reads it,
+		// so that the update below does not depend on the order of the tiles.
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+		for ( amrex::MFIter mfi(*water_conc_old[lev],true); mfi.isValid(); ++mfi )
 		{
-			const amrex::Box& bx = mfi.validbox();
+			const amrex::Box& bx = mfi.tilebox();
 			amrex::Array4<amrex::Real> const& water_old_box = (*water_conc_old[lev]).array(mfi);
-			amrex::Array4<amrex::Real> const& water_box = (*water_conc[lev]).array(mfi);
-			amrex::Array4<amrex::Real> const& time_box = (*damage_start_time[lev]).array(mfi);
 
 			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
 				if(std::isnan(water_old_box(i,j,k,0))) Util::Abort(INFO, "Nan found in WATER_OLD(i,j,k)");
@@ -339,7 +351,20 @@ PolymerDegradation::Advance (int lev, amrex::Real time, amrex::Real dt)
 					Util::Warning(INFO,"Water concentration exceeded 1 at (", i, ",", j, ",", "k) and lev = ", lev, " Resetting");
 					water_old_box(i,j,k,0) = 1.0;
 				}
-				
+			});
+		}
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+		for ( amrex::MFIter mfi(*water_conc[lev],true); mfi.isValid(); ++mfi )
+		{
+			const amrex::Box& bx = mfi.tilebox();
+			amrex::Array4<const amrex::Real> const& water_old_box = (*water_conc_old[lev]).array(mfi);
+			amrex::Array4<amrex::Real> const& water_box = (*water_conc[lev]).array(mfi);
+			amrex::Array4<amrex::Real> const& time_box = (*damage_start_time[lev]).array(mfi);
+
+			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k){
 				water_box(i,j,k,0) = water_old_box(i,j,k,0) + dt * water.diffusivity * Numeric::Hessian(water_old_box,i,j,k,0,DX).trace();
 				
 				if(water_box(i,j,k,0) > 1.0)
@@ -350,16 +375,30 @@ PolymerDegradation::Advance (int lev, amrex::Real time, amrex::Real dt)
 				if(water_old_box(i,j,k,0) < 1.E-2 && water_box(i,j,k,0) > 1.E-2)
 					time_box(i,j,k,0) = time;
 			});
+
+			// Diffusive fluxes (times dt) used above, for refluxing
+			if (RefluxOn())
+				for (int d = 0; d < AMREX_SPACEDIM; d++)
+				{
+					amrex::Array4<Set::Scalar> const& flux = Flux(water.flux,lev,d).array(mfi);
+					const amrex::IntVect e = amrex::IntVect::TheDimensionVector(d);
+					amrex::ParallelFor (mfi.nodaltilebox(d),[=] AMREX_GPU_DEVICE(int i, int j, int k){
+						amrex::IntVect iv(AMREX_D_DECL(i,j,k));
+						flux(iv) += - dt * water.diffusivity * (water_old_box(iv) - water_old_box(iv - e)) / DX[d];
+					});
+				}
 		}
-		Util::Message(INFO);
-		//water_conc[lev]->FillBoundary();
 	}
 
-	if(thermal.on)
+	if(thermal.on && group == thermal.group)
 	{
+		std::swap(*Temp_old[lev], *Temp[lev]);
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 		for ( amrex::MFIter mfi(*Temp[lev],true); mfi.isValid(); ++mfi )
 		{
-			const amrex::Box& bx = mfi.validbox();
+			const amrex::Box& bx = mfi.tilebox();
 			amrex::Array4<const amrex::Real> const& Temp_old_box = (*Temp_old[lev]).array(mfi);
 			amrex::Array4<amrex::Real> const& Temp_box = (*Temp[lev]).array(mfi);
 			
@@ -368,7 +407,18 @@ PolymerDegradation::Advance (int lev, amrex::Real time, amrex::Real dt)
 			});
 		}
 	}
+}
+
+void
+PolymerDegradation::Advance (int lev, amrex::Real time, amrex::Real dt)
+{
+	Util::Message(INFO, "Enter");
+	std::swap(*eta_old[lev], 	*eta_new[lev]);
+
 	Util::Message(INFO);
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 	for ( amrex::MFIter mfi(*eta_new[lev],true); mfi.isValid(); ++mfi )
 	{
 		const amrex::Box& bx = mfi.growntilebox(1);
@@ -450,57 +500,6 @@ PolymerDegradation::~PolymerDegradation()
 	delete damage.bc;
 }
 
-void
-PolymerDegradation::TagCellsForRefinement (int lev, amrex::TagBoxArray& a_tags, amrex::Real /*time*/, int /*ngrow*/)
-{
-	const amrex::Real *DX = geom[lev].CellSize();
-	const Set::Vector dx(DX);
-	const Set::Scalar dxnorm = dx.lpNorm<2>();
-
-	if(water.on)
-	{
-		for (amrex::MFIter mfi(*water_conc[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-		{
-			const amrex::Box 							&bx 		= mfi.tilebox();
-			amrex::Array4<char> const 					&tags 		= a_tags.array(mfi);
-			amrex::Array4<const Set::Scalar> const 		&water_box 	= (*water_conc[lev]).array(mfi);
-			amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-				Set::Vector grad = Numeric::Gradient(water_box, i, j, k, 0, DX);
-				if (dxnorm * grad.lpNorm<2>() > water.refinement_threshold)
-					tags(i, j, k) = amrex::TagBox::SET;
-			});
-		}
-	}
-
-	if(thermal.on)
-	{
-		for (amrex::MFIter mfi(*Temp[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-		{
-			const amrex::Box 							&bx 		= mfi.tilebox();
-			amrex::Array4<char> const 					&tags 		= a_tags.array(mfi);
-			amrex::Array4<const Set::Scalar> const 		&Temp_box 	= (*Temp[lev]).array(mfi);
-			amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-				Set::Vector grad = Numeric::Gradient(Temp_box, i, j, k, 0, DX);
-				if (dxnorm * grad.lpNorm<2>() > thermal.refinement_threshold)
-					tags(i, j, k) = amrex::TagBox::SET;
-			});
-		}
-	}
-
-	for (amrex::MFIter mfi(*eta_new[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-	{
-		const amrex::Box 							&bx 		= mfi.tilebox();
-		amrex::Array4<char> const 					&tags 		= a_tags.array(mfi);
-		amrex::Array4<const Set::Scalar> const 		&eta_box 	= (*eta_new[lev]).array(mfi);
-		amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-			Set::Vector grad = Numeric::Gradient(eta_box, i, j, k, 0, DX);
-			if (dxnorm * grad.lpNorm<2>() > damage.refinement_threshold)
-				tags(i, j, k) = amrex::TagBox::SET;
-		});
-	}
-	Util::Message(INFO);
-}
-
 void
 PolymerDegradation::DegradeMaterial(int lev, amrex::FabArray<amrex::BaseFab<pd_model_type> > &model)
 {
@@ -517,6 +516,9 @@ PolymerDegradation::DegradeMaterial(int lev, amrex::FabArray<amrex::BaseFab<pd_m
 					   dz(AMREX_D_DECL(0,0,1)));
 	eta_new[lev]->FillBoundary();
 
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 	for (amrex::MFIter mfi(model,true); mfi.isValid(); ++mfi)
 	{
 		amrex::Box box = mfi.growntilebox(2);
@@ -597,6 +599,9 @@ PolymerDegradation::TimeStepBegin(amrex::Real time, int iter)
 		
 		eta_new[ilev]->FillBoundary();
 
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 		for (amrex::MFIter mfi(*material.model[ilev],true); mfi.isValid(); ++mfi)
 		{
 			amrex::Box box = mfi.growntilebox(2);
@@ -624,6 +629,9 @@ PolymerDegradation::TimeStepBegin(amrex::Real time, int iter)
 	elastic_op.define(geom, grids, dmap, info);
 
 	elastic_op.setMaxOrder(elastic.linop_maxorder);
+	elastic_op.SetGalerkin(elastic.galerkin);
+	elastic_op.SetMixedPrecision(elastic.mixed_precision);
+	elastic_op.SetSmoother(elastic.smoother, elastic.chebyshev_degree);
 	
 	for (int ilev = 0; ilev < nlevels; ++ilev)
 	{
@@ -657,8 +665,8 @@ PolymerDegradation::TimeStepBegin(amrex::Real time, int iter)
 		
 		for (int ilev = 0; ilev < nlevels; ilev++) if (displacement[ilev]->contains_nan()) Util::Warning(INFO);
 
-		if (elastic.bottom_solver == "cg") solver.setBottomSolver(MLMG::BottomSolver::cg);
-		else if (elastic.bottom_solver == "bicgstab") solver.setBottomSolver(MLMG::BottomSolver::bicgstab);
+		solver.setBottomSolver(elastic.bottom_solver);
+		solver.setKrylov(elastic.krylov);
 		solver.solve(displacement,rhs,material.model,elastic.tol_rel,elastic.tol_abs);
 		solver.compResidual(residual,displacement,rhs,material.model);
 		
@@ -670,9 +678,12 @@ PolymerDegradation::TimeStepBegin(amrex::Real time, int iter)
 		}
 		for (int lev = 0; lev < nlevels; lev++)
 		{
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 			for (amrex::MFIter mfi(*stress[lev],true); mfi.isValid(); ++mfi)
 			{
-				const amrex::Box& box = mfi.validbox();
+				const amrex::Box& box = mfi.tilebox();
 				amrex::Array4<const Set::Scalar> const& stress_box = (*stress[lev]).array(mfi);
 				amrex::Array4<Set::Scalar> const& stress_vm_box = (*stress_vm[lev]).array(mfi);
 				amrex::Array4<const Set::Scalar> const& eta_box = (*eta_new[lev]).array(mfi);
@@ -726,8 +737,8 @@ PolymerDegradation::TimeStepBegin(amrex::Real time, int iter)
 			solver.setBottomToleranceAbs(elastic.cg_tol_abs) ;
 			for (int ilev = 0; ilev < nlevels; ilev++) if (displacement[ilev]->contains_nan()) Util::Warning(INFO);
 
-			if (elastic.bottom_solver == "cg") solver.setBottomSolver(MLMG::BottomSolver::cg);
-			else if (elastic.bottom_solver == "bicgstab") solver.setBottomSolver(MLMG::BottomSolver::bicgstab);
+			solver.setBottomSolver(elastic.bottom_solver);
+			solver.setKrylov(elastic.krylov);
 			solver.solve(displacement, rhs, material.model, elastic.tol_rel, elastic.tol_abs);
 			//solver.solve(GetVecOfPtrs(displacement), GetVecOfConstPtrs(rhs), elastic.tol_rel, elastic.tol_abs);
 			//solver.compResidual(GetVecOfPtrs(residual),GetVecOfPtrs(displacement),GetVecOfConstPtrs(rhs));
@@ -739,9 +750,12 @@ PolymerDegradation::TimeStepBegin(amrex::Real time, int iter)
 			}
 			for (int lev = 0; lev < nlevels; lev++)
 			{
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 				for (amrex::MFIter mfi(*stress[lev],true); mfi.isValid(); ++mfi)
 				{
-					const amrex::Box& box = mfi.validbox();
+					const amrex::Box& box = mfi.tilebox();
 					amrex::Array4<const Set::Scalar> const& stress_box = (*stress[lev]).array(mfi);
 					amrex::Array4<Set::Scalar> const& stress_vm_box = (*stress_vm[lev]).array(mfi);
 					amrex::Array4<const Set::Scalar> const& eta_box = (*eta_new[lev]).array(mfi);
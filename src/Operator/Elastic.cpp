@@ -47,6 +47,8 @@ Elastic<SYM>::define (const Vector<Geometry>& a_geom,
 
 	Operator::define(a_geom,a_grids,a_dmap,a_info,a_factory);
 
+	// Fapply evaluates one layer of ghost nodes and takes a centered
+	// derivative of the modulus there, so two ghost layers are needed.
 	int model_nghost = 2;
 
 	m_ddw_mf.resize(m_num_amr_levels);
@@ -87,6 +89,7 @@ Elastic<SYM>::SetModel (MATRIX4 &a_model)
 		}
 	}
 	m_model_set = true;
+	InvalidateBottom();
 }
 
 template <int SYM>
@@ -123,6 +126,7 @@ Elastic<SYM>::SetModel (int amrlev, const amrex::FabArray<amrex::BaseFab<MATRIX4
 
 
 	m_model_set = true;
+	InvalidateBottom();
 }
 
 template<int SYM>
@@ -131,8 +135,13 @@ Elastic<SYM>::Fapply (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u)
 {
 	BL_PROFILE("Operator::Elastic::Fapply()");
 
+	if (GalerkinApply(amrlev,mglev,a_f,a_u)) return;
+
 	amrex::Box domain(m_geom[amrlev][mglev].Domain());
 	domain.convert(amrex::IntVect::TheNodeVector());
+	const amrex::Box stendomain = StencilDomain(amrlev,mglev);
+	const bool pin = m_geom[amrlev][mglev].isAllPeriodic();
+	const Dim3 dlo= amrex::lbound(domain), dhi = amrex::ubound(domain);
 
 	const Real* DX = m_geom[amrlev][mglev].CellSize();
 
@@ -146,7 +155,7 @@ Elastic<SYM>::Fapply (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u)
 		amrex::Array4<const amrex::Real> const& U = a_u.array(mfi);
 		amrex::Array4<amrex::Real> const& F       = a_f.array(mfi);
 
-		const Dim3 lo= amrex::lbound(domain), hi = amrex::ubound(domain);
+		const Dim3 lo= amrex::lbound(stendomain), hi = amrex::ubound(stendomain);
 			
 		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
 					
@@ -161,7 +170,7 @@ Elastic<SYM>::Fapply (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u)
 
 				// Determine if a special stencil will be necessary for first derivatives
 				std::array<Numeric::StencilType,AMREX_SPACEDIM>
-					sten = Numeric::GetStencil(i,j,k,domain);
+					sten = Numeric::GetStencil(i,j,k,stendomain);
 
 				// The displacement gradient tensor
 				Set::Matrix gradu; // gradu(i,j) = u_{i,j)
@@ -180,7 +189,11 @@ Elastic<SYM>::Fapply (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u)
 				// Boundary conditions
 				/// \todo Important: we need a way to handle corners and edges.
 				amrex::IntVect m(AMREX_D_DECL(i,j,k));
-				if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin)) 
+				if (pin && AMREX_D_TERM((i == dlo.x || i == dhi.x), && (j == dlo.y || j == dhi.y), && (k == dlo.z || k == dhi.z)))
+				{
+					f = u;
+				}
+				else if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin)) 
 				{
 					f = (*m_bc)(u,gradu,sig,i,j,k,domain);
 				}
@@ -245,8 +258,13 @@ Elastic<SYM>::Diagonal (int amrlev, int mglev, MultiFab& a_diag)
 {
 	BL_PROFILE("Operator::Elastic::Diagonal()");
 
+	if (GalerkinDiagonal(amrlev,mglev,a_diag)) return;
+
 	amrex::Box domain(m_geom[amrlev][mglev].Domain());
 	domain.convert(amrex::IntVect::TheNodeVector());
+	const amrex::Box stendomain = StencilDomain(amrlev,mglev);
+	const bool pin = m_geom[amrlev][mglev].isAllPeriodic();
+	const Dim3 dlo= amrex::lbound(domain), dhi = amrex::ubound(domain);
 	const Real* DX = m_geom[amrlev][mglev].CellSize();
 	
 	for (MFIter mfi(a_diag, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
@@ -258,7 +276,7 @@ Elastic<SYM>::Diagonal (int amrlev, int mglev, MultiFab& a_diag)
 		amrex::Array4<MATRIX4> const& DDW         = (*(m_ddw_mf[amrlev][mglev])).array(mfi);
 		amrex::Array4<amrex::Real> const& diag    = a_diag.array(mfi);
 
-		const Dim3 lo= amrex::lbound(domain), hi = amrex::ubound(domain);
+		const Dim3 lo= amrex::lbound(stendomain), hi = amrex::ubound(stendomain);
 			
 		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
 
@@ -268,7 +286,7 @@ Elastic<SYM>::Diagonal (int amrlev, int mglev, MultiFab& a_diag)
 					    AMREX_D_DECL(xmax = (i == hi.x), ymax = (j==hi.y), zmax = (k==hi.z));
 
 				std::array<Numeric::StencilType,AMREX_SPACEDIM> sten
-					= Numeric::GetStencil(i,j,k,domain);
+					= Numeric::GetStencil(i,j,k,stendomain);
 
 
 				
@@ -302,7 +320,11 @@ Elastic<SYM>::Diagonal (int amrlev, int mglev, MultiFab& a_diag)
 					Set::Matrix sig = DDW(i,j,k)*gradu;
 
 					amrex::IntVect m(AMREX_D_DECL(i,j,k));
-					if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin)) 
+					if (pin && AMREX_D_TERM((i == dlo.x || i == dhi.x), && (j == dlo.y || j == dhi.y), && (k == dlo.z || k == dhi.z)))
+					{
+						diag(i,j,k,p) = 1.0;
+					}
+					else if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin)) 
 					{
 						Set::Vector u = Set::Vector::Zero();
 						u(p) = 1.0;
@@ -605,21 +627,10 @@ Elastic<SYM>::averageDownCoeffs ()
 {
 	BL_PROFILE("Elastic::averageDownCoeffs()");
 	
-	for (int amrlev = m_num_amr_levels-1; amrlev > 0; --amrlev)
+	for (int amrlev = m_num_amr_levels-1; amrlev >= 0; --amrlev)
 	{
 		averageDownCoeffsSameAmrLevel(amrlev);
 	}
-
-	averageDownCoeffsSameAmrLevel(0);
-	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
-	{
-	 	for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
-	 	{
-	 		if (m_ddw_mf[amrlev][mglev]) {
-	 			FillBoundaryCoeff(*m_ddw_mf[amrlev][mglev], m_geom[amrlev][mglev]);
-	 		}
-	 	}
-	}
 }
 
 template<int SYM>
@@ -628,12 +639,18 @@ Elastic<SYM>::averageDownCoeffsSameAmrLevel (int amrlev)
 {
 	BL_PROFILE("Elastic::averageDownCoeffsSameAmrLevel()");
 
+	// The finest MG level is set directly by SetModel; every coarser level
+	// is exchanged once, right after it is restricted, so that its ghost
+	// nodes are valid before it is used as the fine level of the next one.
+	FillBoundaryCoeff(*m_ddw_mf[amrlev][0], m_geom[amrlev][0]);
+
  	for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
  	{
 		amrex::Box cdomain(m_geom[amrlev][mglev].Domain());
 		cdomain.convert(amrex::IntVect::TheNodeVector());
 		amrex::Box fdomain(m_geom[amrlev][mglev-1].Domain());
 		fdomain.convert(amrex::IntVect::TheNodeVector());
+		const amrex::Box cstendomain = StencilDomain(amrlev,mglev);
 
 		MultiTab& crse = *m_ddw_mf[amrlev][mglev];
 		MultiTab& fine = *m_ddw_mf[amrlev][mglev-1];
@@ -643,19 +660,32 @@ Elastic<SYM>::averageDownCoeffsSameAmrLevel (int amrlev)
 		
 		BoxArray newba = crseba;
 		newba.refine(2);
+
+		// The restriction stencil reaches one fine node past each coarse
+		// node. MG levels are normally coarsened in place, in which case the
+		// fine data (with its ghost nodes already filled) is used as-is and
+		// nothing is communicated. Otherwise only that one layer is copied.
 		MultiTab fine_on_crseba;
-		fine_on_crseba.define(newba,crse.DistributionMap(),1,4);
-		fine_on_crseba.ParallelCopy(fine,0,0,1,2,4,m_geom[amrlev][mglev].periodicity());
+		const MultiTab *fsrc = &fine;
+		if (newba != fineba || crse.DistributionMap() != fine.DistributionMap())
+		{
+			fine_on_crseba.define(newba,crse.DistributionMap(),1,1);
+			fine_on_crseba.ParallelCopy(fine,0,0,1,1,1,m_geom[amrlev][mglev].periodicity());
+			fsrc = &fine_on_crseba;
+		}
 
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
 		for (MFIter mfi(crse, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 		{
 			Box bx = mfi.tilebox();
 			bx = bx & cdomain;
 
-			amrex::Array4<const Set::Matrix4<AMREX_SPACEDIM,SYM>> const& fdata = fine_on_crseba.array(mfi);
+			amrex::Array4<const Set::Matrix4<AMREX_SPACEDIM,SYM>> const& fdata = fsrc->const_array(mfi);
 			amrex::Array4<Set::Matrix4<AMREX_SPACEDIM,SYM>> const& cdata       = crse.array(mfi);
 
-			const Dim3 lo= amrex::lbound(cdomain), hi = amrex::ubound(cdomain);
+			const Dim3 lo= amrex::lbound(cstendomain), hi = amrex::ubound(cstendomain);
 
 			// I,J,K == coarse coordinates
 			// i,j,k == fine coordinates
@@ -714,17 +744,10 @@ void
 Elastic<SYM>::FillBoundaryCoeff (MultiTab& sigma, const Geometry& geom)
 {
 	BL_PROFILE("Elastic::FillBoundaryCoeff()");
-	for (int i = 0; i < 2; i++)
-	{
-		MultiTab & mf = sigma;
-		mf.FillBoundary(geom.periodicity());
-		const int ncomp = mf.nComp();
-		const int ng1 = 1;
-		const int ng2 = 2;
-		MultiTab tmpmf(mf.boxArray(), mf.DistributionMap(), ncomp, ng1);
-	  	tmpmf.copy(mf,0,0,ncomp,ng2,ng1,geom.periodicity());
-		mf.ParallelCopy   (tmpmf, 0, 0, ncomp, ng1, ng2, geom.periodicity());
-	}
+	// Ghost nodes outside the domain are never read: Fapply, Diagonal and
+	// the restriction all switch to one-sided stencils at the domain
+	// boundary. A single exchange of the ghost nodes is therefore enough.
+	sigma.FillBoundary(geom.periodicity());
 }
 
 template class Elastic<Set::Sym::Major>;
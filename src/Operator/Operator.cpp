@@ -3,7 +3,9 @@
 #include <AMReX_MLCellLinOp.H>
 #include <AMReX_MLNodeLap_K.H>
 #include <AMReX_MultiFabUtil.H>
+#include <eigen3/Eigen/SparseLU>
 #include "Util/Color.H"
+#include "Util/Random.H"
 #include "Set/Set.H"
 #include "Operator.H"
 
@@ -13,6 +15,27 @@ namespace Operator {
 // constexpr amrex::IntVect AMREX_D_DECL(Operator<Grid::Node>::dx,Operator<Grid::Node>::dy,Operator<Grid::Node>::dz);
 constexpr amrex::IntVect AMREX_D_DECL(Operator<Grid::Cell>::dx,Operator<Grid::Cell>::dy,Operator<Grid::Cell>::dz);
 
+/// Copy (or, with invert, take the reciprocal of the nonzero entries of) a double
+/// MultiFab into a single precision FabArray with the same layout, ghost nodes included
+static void ToSinglePrecision (amrex::FabArray<amrex::BaseFab<float> > &dst, const amrex::MultiFab &src, bool invert = false)
+{
+	const int ncomp = src.nComp();
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+	for (MFIter mfi(src, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		const Box bx = mfi.growntilebox();
+		amrex::Array4<const amrex::Real> const& srcarr = src.const_array(mfi);
+		amrex::Array4<float> const& dstarr = dst.array(mfi);
+		amrex::ParallelFor (bx, ncomp, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) {
+			const amrex::Real v = srcarr(i,j,k,n);
+			if (!invert) dstarr(i,j,k,n) = (float)v;
+			else dstarr(i,j,k,n) = (v != 0.0) ? (float)(1.0/v) : 0.0f;
+		});
+	}
+}
+
 void Operator<Grid::Node>::Diagonal (bool recompute)
 {
 	BL_PROFILE(Color::FG::Yellow + "Operator::Diagonal()" + Color::Reset);
@@ -28,69 +51,104 @@ void Operator<Grid::Node>::Diagonal (bool recompute)
 			Diagonal(amrlev,mglev,*m_diag[amrlev][mglev]);
 		}
 	}
+
+	m_diag_inv_sp.clear();
+	if (m_mixed_precision)
+	{
+		// Only amrlev 0 has Galerkin stencils; coarse MG levels of finer AMR
+		// levels are rediscretized and stay in double precision.
+		const int amrlev = 0;
+		m_diag_inv_sp.resize(m_num_amr_levels);
+		m_diag_inv_sp[amrlev].resize(m_num_mg_levels[amrlev]);
+		for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
+		{
+			const MultiFab &diag = *m_diag[amrlev][mglev];
+			m_diag_inv_sp[amrlev][mglev].reset(new amrex::FabArray<amrex::BaseFab<float> >(diag.boxArray(), diag.DistributionMap(),
+												       diag.nComp(), diag.nGrow()));
+			ToSinglePrecision(*m_diag_inv_sp[amrlev][mglev], diag, true);
+		}
+	}
 }
 
 void Operator<Grid::Node>::Diagonal (int amrlev, int mglev, amrex::MultiFab &diag)
 {
 	BL_PROFILE("Operator::Diagonal()");
-	//Util::Message(INFO);
 
-	int ncomp = diag.nComp();
-	int nghost = 0;
+	if (GalerkinDiagonal(amrlev, mglev, diag) || AnalyticDiagonal(amrlev, mglev, diag))
+	{
+		realFillBoundary(diag, m_geom[amrlev][mglev]);
+		return;
+	}
 
-	int sep = 2;
-	int num = AMREX_D_TERM(sep,*sep,*sep);
-	int cntr = 0;
+	const int ncomp = diag.nComp();
+	const int nghost = getNGrow();
+	const int sep = DiagonalStencilWidth() + 1;
+	const int ncolors = AMREX_D_TERM(sep,*sep,*sep);
 
-	amrex::MultiFab x(m_diag[amrlev][mglev]->boxArray(), m_diag[amrlev][mglev]->DistributionMap(), ncomp, nghost);
-	amrex::MultiFab Ax(m_diag[amrlev][mglev]->boxArray(), m_diag[amrlev][mglev]->DistributionMap(), ncomp, nghost);
+	amrex::MultiFab x(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
+	amrex::MultiFab Ax(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
+	diag.setVal(0.0);
 
-	for (MFIter mfi(x, false); mfi.isValid(); ++mfi)
+	// Color is a function of the global node index, so every box (and its ghost
+	// nodes) is probed consistently without any communication.
+	for (int color = 0; color < ncolors; color++)
 	{
-		const Box& bx = mfi.validbox();
-		amrex::FArrayBox       &diagfab = diag[mfi];
-		amrex::FArrayBox       &xfab    = x[mfi];
-		amrex::FArrayBox       &Axfab   = Ax[mfi];
-
-		diagfab.setVal(0.0);
-				
-		for (int i = 0; i < num; i++)
+		const amrex::IntVect c(AMREX_D_DECL(color % sep, (color / sep) % sep, color / (sep*sep)));
+		for (int n = 0; n < ncomp; n++)
 		{
-			for (int n = 0; n < ncomp; n++)
+			x.setVal(0.0);
+			Ax.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+			for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 			{
-				xfab.setVal(0.0);
-				Axfab.setVal(0.0);
-				
-				//BL_PROFILE_VAR("Operator::Part1", part1); 
-				AMREX_D_TERM(for (int m1 = bx.loVect()[0]; m1<=bx.hiVect()[0]; m1++),
-					     for (int m2 = bx.loVect()[1]; m2<=bx.hiVect()[1]; m2++),
-					     for (int m3 = bx.loVect()[2]; m3<=bx.hiVect()[2]; m3++))
-				{
-					amrex::IntVect m(AMREX_D_DECL(m1,m2,m3));
-				
-					if ( m1%sep == i/sep   &&   m2%sep == i%sep ) xfab(m,n) = 1.0;
-					else xfab(m,n) = 0.0;
-				}
-				//BL_PROFILE_VAR_STOP(part1);
-
-				BL_PROFILE_VAR("Operator::Part2", part2); 
-				Util::Message(INFO,"Calling fapply...",cntr++);
-				Fapply(amrlev,mglev,Ax,x);
-				BL_PROFILE_VAR_STOP(part2);
-						
-				//BL_PROFILE_VAR("Operator::Part3", part3); 
-				Axfab.mult(xfab,n,n,1);
-				diagfab.plus(Axfab,n,n,1);
-				//BL_PROFILE_VAR_STOP(part3);
+				const Box& bx = mfi.growntilebox();
+				amrex::Array4<amrex::Real> const& xarr = x.array(mfi);
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					amrex::IntVect m(AMREX_D_DECL(i,j,k));
+					for (int d = 0; d < AMREX_SPACEDIM; d++)
+						if (((m[d] % sep) + sep) % sep != c[d]) return;
+					xarr(i,j,k,n) = 1.0;
+				});
+			}
+
+			Fapply(amrlev,mglev,Ax,x);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+			for (MFIter mfi(diag, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				const Box& bx = mfi.tilebox();
+				amrex::Array4<const amrex::Real> const& xarr = x.array(mfi);
+				amrex::Array4<const amrex::Real> const& Axarr = Ax.array(mfi);
+				amrex::Array4<amrex::Real> const& diagarr = diag.array(mfi);
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					if (xarr(i,j,k,n) != 0.0) diagarr(i,j,k,n) = Axarr(i,j,k,n);
+				});
 			}
 		}
 	}
+
+	realFillBoundary(diag, m_geom[amrlev][mglev]);
 }
 
 void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, const amrex::MultiFab& b) const
 {
 	BL_PROFILE("Operator::Fsmooth()");
 
+	if (m_direct_bottom && amrlev == 0 && mglev == m_num_mg_levels[0]-1)
+	{
+		DirectBottomSolve(x,b);
+		return;
+	}
+	if (m_chebyshev)
+	{
+		ChebyshevSmooth(amrlev,mglev,x,b);
+		return;
+	}
+
 	amrex::Box domain(m_geom[amrlev][mglev].Domain());
 
 	int ncomp = b.nComp();
@@ -98,9 +156,17 @@ void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, c
 	
 	Set::Scalar omega = 2./3.; // Damping factor (very important!)
 
+	// On coarse levels in mixed precision mode the update is computed in single
+	// precision from a float inverse diagonal; Ax and b - Ax stay in double.
+	const bool single = m_mixed_precision && amrlev == 0 && mglev > 0;
+
 	amrex::MultiFab Ax(x.boxArray(), x.DistributionMap(), ncomp, nghost);
-	amrex::MultiFab Dx(x.boxArray(), x.DistributionMap(), ncomp, nghost);
-	amrex::MultiFab Rx(x.boxArray(), x.DistributionMap(), ncomp, nghost);
+	amrex::MultiFab Dx, Rx;
+	if (!single)
+	{
+		Dx.define(x.boxArray(), x.DistributionMap(), ncomp, nghost);
+		Rx.define(x.boxArray(), x.DistributionMap(), ncomp, nghost);
+	}
 	
 	if (!m_diagonal_computed) Util::Abort(INFO,"Operator::Diagonal() must be called before using Fsmooth");
 
@@ -110,20 +176,24 @@ void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, c
 	{
 		Fapply(amrlev,mglev,Ax,x); // find Ax
 
-		amrex::MultiFab::Copy(Dx,x,0,0,ncomp,nghost); // Dx = x
-		amrex::MultiFab::Multiply(Dx,*m_diag[amrlev][mglev],0,0,ncomp,nghost); // Dx *= diag  (Dx = x*diag)
+		if (!single)
+		{
+			amrex::MultiFab::Copy(Dx,x,0,0,ncomp,nghost); // Dx = x
+			amrex::MultiFab::Multiply(Dx,*m_diag[amrlev][mglev],0,0,ncomp,nghost); // Dx *= diag  (Dx = x*diag)
 
-		amrex::MultiFab::Copy(Rx,Ax,0,0,ncomp,nghost); // Rx = Ax
-		amrex::MultiFab::Subtract(Rx,Dx,0,0,ncomp,nghost); // Rx -= Dx  (Rx = Ax - Dx)
+			amrex::MultiFab::Copy(Rx,Ax,0,0,ncomp,nghost); // Rx = Ax
+			amrex::MultiFab::Subtract(Rx,Dx,0,0,ncomp,nghost); // Rx -= Dx  (Rx = Ax - Dx)
+		}
 
 		for (MFIter mfi(x, false); mfi.isValid(); ++mfi)
 		{
 			const Box& bx = mfi.validbox();
 			amrex::FArrayBox       &xfab    = x[mfi];
 			const amrex::FArrayBox &bfab    = b[mfi];
-			//const amrex::FArrayBox &Axfab   = Ax[mfi];
-			const amrex::FArrayBox &Rxfab   = Rx[mfi];
+			const amrex::FArrayBox &Axfab   = Ax[mfi];
 			const amrex::FArrayBox &diagfab = (*m_diag[amrlev][mglev])[mfi];
+			const amrex::FArrayBox *Rxfab   = single ? nullptr : &Rx[mfi];
+			const amrex::BaseFab<float> *dinvfab = single ? &(*m_diag_inv_sp[amrlev][mglev])[mfi] : nullptr;
 
 			for (int n = 0; n < ncomp; n++)
 			{
@@ -150,20 +220,155 @@ void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, c
 						continue;
 					}
 
-					//xfab(m,n) = xfab(m,n) + omega*(bfab(m,n) - Axfab(m,n))/diagfab(m,n);
-					xfab(m,n) = (1.-omega)*xfab(m,n) + omega*(bfab(m,n) - Rxfab(m,n))/diagfab(m,n);
+					if (single)
+						xfab(m,n) += (amrex::Real)((float)omega * (float)(bfab(m,n) - Axfab(m,n)) * (*dinvfab)(m,n));
+					else
+						xfab(m,n) = (1.-omega)*xfab(m,n) + omega*(bfab(m,n) - (*Rxfab)(m,n))/diagfab(m,n);
 				}
 			}
 		}
 	}
-	amrex::Geometry geom = m_geom[amrlev][mglev];
-	realFillBoundary(x,geom);
+	// Sync the shared nodes first so that the ghost nodes are filled from
+	// consistent data; the next applyBC on x can then skip its exchange.
 	nodalSync(amrlev, mglev, x);
+	FillGhosts(x,m_geom[amrlev][mglev]);
+}
+
+void Operator<Grid::Node>::ChebyshevSmooth (int amrlev, int mglev, amrex::MultiFab& x, const amrex::MultiFab& b) const
+{
+	BL_PROFILE("Operator::ChebyshevSmooth()");
+
+	if (!m_diagonal_computed) Util::Abort(INFO,"Operator::Diagonal() must be called before using Fsmooth");
+
+	const int ncomp = b.nComp();
+	const int nghost = 2;
+	const MultiFab &diag = *m_diag[amrlev][mglev];
+
+	// Chebyshev iteration for D^{-1}A on [lower, upper] (e.g. Adams et al.,
+	// J. Comput. Phys. 188 (2003)).
+	const Set::Scalar upper = m_chebyshev_lambda[amrlev][mglev];
+	const Set::Scalar lower = upper / m_chebyshev_ratio;
+	const Set::Scalar theta = 0.5*(upper + lower);
+	const Set::Scalar delta = 0.5*(upper - lower);
+	const Set::Scalar sigma = theta / delta;
+	Set::Scalar rho = 1.0 / sigma;
+
+	amrex::MultiFab Ax(x.boxArray(), x.DistributionMap(), ncomp, nghost);
+	amrex::MultiFab d(x.boxArray(), x.DistributionMap(), ncomp, 0);
+	d.setVal(0.0);
+
+	for (int deg = 0; deg < m_chebyshev_degree; deg++)
+	{
+		Fapply(amrlev,mglev,Ax,x);
+
+		// r = D^{-1}(b - Ax)
+		// d = r/theta                                   (first step)
+		// d = rho_{k} rho_{k-1} d + 2 rho_{k}/delta r   (subsequent steps)
+		const Set::Scalar rho_new = (deg == 0) ? rho : 1.0 / (2.0*sigma - rho);
+		const Set::Scalar cd = (deg == 0) ? 0.0 : rho_new*rho;
+		const Set::Scalar cr = (deg == 0) ? 1.0/theta : 2.0*rho_new/delta;
+		rho = rho_new;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+		for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			const Box& bx = mfi.tilebox();
+			amrex::Array4<amrex::Real> const& xarr = x.array(mfi);
+			amrex::Array4<amrex::Real> const& darr = d.array(mfi);
+			amrex::Array4<const amrex::Real> const& barr = b.array(mfi);
+			amrex::Array4<const amrex::Real> const& Axarr = Ax.array(mfi);
+			amrex::Array4<const amrex::Real> const& diagarr = diag.array(mfi);
+			amrex::ParallelFor (bx, ncomp, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) {
+				const Set::Scalar r = (diagarr(i,j,k,n) != 0.0) ? (barr(i,j,k,n) - Axarr(i,j,k,n)) / diagarr(i,j,k,n) : 0.0;
+				darr(i,j,k,n) = cd*darr(i,j,k,n) + cr*r;
+				xarr(i,j,k,n) += darr(i,j,k,n);
+			});
+		}
+
+		nodalSync(amrlev, mglev, x);
+		if (deg < m_chebyshev_degree - 1) realFillBoundary(x,m_geom[amrlev][mglev]);
+	}
+	FillGhosts(x,m_geom[amrlev][mglev]);
+}
+
+void Operator<Grid::Node>::EstimateChebyshevBounds ()
+{
+	BL_PROFILE("Operator::EstimateChebyshevBounds()");
+
+	// Power iteration on D^{-1}A from a reproducible random start. The estimate
+	// approaches lambda_max from below, so it is padded by 10%.
+	const int niter = 10;
+	const int ncomp = getNComp();
+	const int nghost = 2;
+	const std::uint64_t seed = Util::RandomSeed();
+
+	m_chebyshev_lambda.resize(m_num_amr_levels);
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	{
+		m_chebyshev_lambda[amrlev].assign(m_num_mg_levels[amrlev], 1.0);
+		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+		{
+			const MultiFab &diag = *m_diag[amrlev][mglev];
+			const Geometry &geom = m_geom[amrlev][mglev];
+			amrex::MultiFab v(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
+			amrex::MultiFab Av(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
+			v.setVal(0.0);
+			Av.setVal(0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+			for (MFIter mfi(v, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				const Box& bx = mfi.tilebox();
+				amrex::Array4<amrex::Real> const& varr = v.array(mfi);
+				amrex::ParallelFor (bx, ncomp, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) {
+					varr(i,j,k,n) = 2.0*Util::Random(seed, amrlev, amrex::IntVect(AMREX_D_DECL(i,j,k)), n, mglev) - 1.0;
+				});
+			}
+
+			Set::Scalar lambda = 1.0;
+			for (int iter = 0; iter < niter; iter++)
+			{
+				Set::Scalar vnorm = 0.0;
+				for (int n = 0; n < ncomp; n++) vnorm = std::max(vnorm, v.norm0(n));
+				if (vnorm == 0.0) break;
+				v.mult(1.0/vnorm, 0, ncomp, nghost);
+				nodalSync(amrlev, mglev, v);
+				realFillBoundary(v, geom);
+
+				Fapply(amrlev,mglev,Av,v);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+				for (MFIter mfi(v, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+				{
+					const Box& bx = mfi.tilebox();
+					amrex::Array4<amrex::Real> const& varr = v.array(mfi);
+					amrex::Array4<const amrex::Real> const& Avarr = Av.array(mfi);
+					amrex::Array4<const amrex::Real> const& diagarr = diag.array(mfi);
+					amrex::ParallelFor (bx, ncomp, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) {
+						varr(i,j,k,n) = (diagarr(i,j,k,n) != 0.0) ? Avarr(i,j,k,n) / diagarr(i,j,k,n) : 0.0;
+					});
+				}
+
+				// ||v|| was normalized to 1, so the norm of D^{-1}Av is the estimate
+				lambda = 0.0;
+				for (int n = 0; n < ncomp; n++) lambda = std::max(lambda, v.norm0(n));
+			}
+			if (lambda > 0.0) m_chebyshev_lambda[amrlev][mglev] = 1.1*lambda;
+		}
+	}
+	ForgetGhosts();
 }
 
 void Operator<Grid::Node>::normalize (int amrlev, int mglev, MultiFab& a_x) const
 {
 	BL_PROFILE("Operator::normalize()");
+	ForgetGhosts();
 	amrex::Box domain(m_geom[amrlev][mglev].Domain());
 	domain.convert(amrex::IntVect::TheNodeVector());
 
@@ -283,10 +488,19 @@ void Operator<Grid::Node>::fixUpResidualMask (int amrlev, iMultiFab& resmsk)
 void Operator<Grid::Node>::prepareForSolve ()
 {
 	BL_PROFILE("Operator::prepareForSolve()");
+	if (m_mixed_precision && !m_galerkin)
+		Util::Abort(INFO,"Mixed precision requires Galerkin coarsening (set galerkin = 1)");
+	ForgetGhosts();
 	MLNodeLinOp::prepareForSolve();
 	buildMasks();
+	if (m_setup_frozen && m_diagonal_computed) return;
 	averageDownCoeffs();
+	if (m_galerkin) BuildGalerkin();
+	else { m_galerkin_stencil.clear(); m_galerkin_stencil_sp.clear(); }
 	Diagonal(true);
+	if (m_chebyshev) EstimateChebyshevBounds();
+	if (!BottomCacheable()) m_bottom_factored = false;
+	if (m_direct_bottom && !m_bottom_factored) FactorBottom();
 }
 
 void Operator<Grid::Node>::restriction (int amrlev, int cmglev, MultiFab& crse, MultiFab& fine) const
@@ -297,6 +511,7 @@ void Operator<Grid::Node>::restriction (int amrlev, int cmglev, MultiFab& crse,
 
 	amrex::Box cdomain = m_geom[amrlev][cmglev].Domain();
 	cdomain.convert(amrex::IntVect::TheNodeVector());
+	const amrex::Box cstendomain = StencilDomain(amrlev,cmglev);
 
 	bool need_parallel_copy = !amrex::isMFIterSafe(crse, fine);
 	MultiFab cfine;
@@ -314,7 +529,7 @@ void Operator<Grid::Node>::restriction (int amrlev, int cmglev, MultiFab& crse,
 		amrex::Array4<const amrex::Real> const& fdata = fine.array(mfi);
 		amrex::Array4<amrex::Real> const& cdata       = pcrse->array(mfi);
 
-		const Dim3 lo= amrex::lbound(cdomain), hi = amrex::ubound(cdomain);
+		const Dim3 lo= amrex::lbound(cstendomain), hi = amrex::ubound(cstendomain);
 
 
 		for (int n = 0; n < crse.nComp(); n++)
@@ -456,15 +671,15 @@ void Operator<Grid::Node>::interpolation (int amrlev, int fmglev, MultiFab& fine
 		fine[mfi].plus(tmpfab,fine_bx,fine_bx,0,0,fine.nComp());
 	}
 
-	amrex::Geometry geom = m_geom[amrlev][fmglev];
-	realFillBoundary(fine,geom);
 	nodalSync(amrlev, fmglev, fine);
+	FillGhosts(fine,m_geom[amrlev][fmglev]);
 }
   
 void Operator<Grid::Node>::averageDownSolutionRHS (int camrlev, MultiFab& crse_sol, MultiFab& /*crse_rhs*/,
 				                                  const MultiFab& fine_sol, const MultiFab& /*fine_rhs*/)
 {
 	BL_PROFILE("Operator::averageDownSolutionRHS()");
+	ForgetGhosts();
 	const auto& amrrr = AMRRefRatio(camrlev);
 	amrex::average_down(fine_sol, crse_sol, 0, crse_sol.nComp(), amrrr);
 	
@@ -501,10 +716,18 @@ void Operator<Grid::Node>::applyBC (int amrlev, int mglev, MultiFab& phi, BCMode
 
 	const Geometry& geom = m_geom[amrlev][mglev];
 
-	if (!skip_fillboundary) {
-
+	if (!skip_fillboundary && !(m_lazy_ghost_fill && m_fresh_ghosts == &phi && m_fresh_generation == m_ghost_generation))
+	{
 		realFillBoundary(phi,geom);
 	}
+	ForgetGhosts();
+}
+
+void Operator<Grid::Node>::FillGhosts(MultiFab &phi, const Geometry &geom) const
+{
+	realFillBoundary(phi,geom);
+	m_fresh_ghosts = &phi;
+	m_fresh_generation = ++m_ghost_generation;
 }
 
 const amrex::FArrayBox &
@@ -569,6 +792,7 @@ void Operator<Grid::Node>::reflux (int crse_amrlev,
 		  MultiFab& fine_res, MultiFab& /*fine_sol*/, const MultiFab& /*fine_rhs*/) const
 {
 	BL_PROFILE("Operator::Elastic::reflux()");
+	ForgetGhosts();
 
 	int ncomp = AMREX_SPACEDIM;
 
@@ -681,6 +905,7 @@ void
 Operator<Grid::Node>::solutionResidual (int amrlev, MultiFab& resid, MultiFab& x, const MultiFab& b,
 			    const MultiFab* /*crse_bcdata*/)
 {
+	ForgetGhosts();
 	const int mglev = 0;
 	const int ncomp = b.nComp();
 	apply(amrlev, mglev, resid, x, BCMode::Inhomogeneous, StateMode::Solution);
@@ -697,8 +922,422 @@ Operator<Grid::Node>::correctionResidual (int amrlev, int mglev, MultiFab& resid
 	apply(amrlev, mglev, resid, x, BCMode::Homogeneous, StateMode::Correction);
 	int ncomp = b.nComp();
 	MultiFab::Xpay(resid, -1.0, b, 0, 0, ncomp, resid.nGrow());
-	amrex::Geometry geom = m_geom[amrlev][mglev];
-	realFillBoundary(resid,geom);
+	// MLMG restricts the residual of the correction next, and restriction
+	// starts with applyBC on it.
+	FillGhosts(resid,m_geom[amrlev][mglev]);
+}
+
+/// \brief Probe color of node m in one direction for BuildGalerkin
+///
+/// Same-colored probes must be at least three nodes apart. Along a periodic
+/// direction with n nodes per period this has to hold across the seam too,
+/// so nodes are colored by their periodic image: the first n - n%3 nodes of
+/// a period cycle through 0,1,2 and the remaining n%3 nodes get colors 3, 4.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+static int GalerkinColor (int m, int lo, int n, bool periodic)
+{
+	if (!periodic) return ((m % 3) + 3) % 3;
+	const int mm = (((m - lo) % n) + n) % n;
+	const int q = n - n % 3;
+	return mm < q ? mm % 3 : 3 + (mm - q);
+}
+
+void
+Operator<Grid::Node>::BuildGalerkin ()
+{
+	BL_PROFILE("Operator::BuildGalerkin()");
+
+	// Only amrlev 0 is coarsened by more than one MG level (for refinement
+	// ratio 2), and its levels cover the whole domain, so there are no
+	// coarse/fine ghost nodes to worry about.
+	const int amrlev = 0;
+	const int ncomp = getNComp();
+	const int nghost = getNGrow();
+	const int nsten = AMREX_D_TERM(3,*3,*3);
+	const int ncoef = ncomp*ncomp*nsten;
+
+	m_galerkin_stencil.clear();
+	m_galerkin_stencil_sp.clear();
+	m_galerkin_stencil.resize(m_num_mg_levels[amrlev]);
+
+	// Coarse levels are built in order, so that A_f on mglev-1 is already the
+	// Galerkin operator when mglev is probed.
+	for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; mglev++)
+	{
+		amrex::Box cdomain(m_geom[amrlev][mglev].Domain());
+		cdomain.convert(amrex::IntVect::TheNodeVector());
+
+		// Number of colors per direction (see GalerkinColor)
+		amrex::GpuArray<int,AMREX_SPACEDIM> lo, len, per, ncol;
+		int ncolor = 1;
+		for (int d = 0; d < AMREX_SPACEDIM; d++)
+		{
+			lo[d] = cdomain.smallEnd(d);
+			len[d] = m_geom[amrlev][mglev].Domain().length(d);
+			per[d] = m_geom[amrlev][mglev].isPeriodic(d);
+			if (per[d] && len[d] < 3)
+				Util::Abort(INFO,"Galerkin coarsening needs at least 3 nodes per periodic direction on every MG level (reduce max_coarsening_level)");
+			ncol[d] = per[d] ? 3 + len[d] % 3 : 3;
+			ncolor *= ncol[d];
+		}
+
+		const BoxArray cba = amrex::convert(m_grids[amrlev][mglev], amrex::IntVect::TheNodeVector());
+		const BoxArray fba = amrex::convert(m_grids[amrlev][mglev-1], amrex::IntVect::TheNodeVector());
+		const DistributionMapping &cdm = m_dmap[amrlev][mglev], &fdm = m_dmap[amrlev][mglev-1];
+
+		MultiFab xc(cba, cdm, ncomp, nghost), Rx(cba, cdm, ncomp, nghost);
+		MultiFab xf(fba, fdm, ncomp, nghost), Axf(fba, fdm, ncomp, nghost), A0f(fba, fdm, ncomp, nghost);
+		std::unique_ptr<MultiFab> stencil(new MultiFab(cba, cdm, ncoef, 1));
+		stencil->setVal(0.0);
+
+		// Any affine part of Fapply (e.g. boundary values) is subtracted from every probe
+		xf.setVal(0.0);
+		A0f.setVal(0.0);
+		Fapply(amrlev,mglev-1,A0f,xf);
+
+		// R A_f P couples coarse nodes at most one apart, so probes three apart
+		// (counting across periodic seams) give whole columns.
+		for (int color = 0; color < ncolor; color++)
+		{
+			amrex::IntVect c;
+			for (int d = 0, q = color; d < AMREX_SPACEDIM; q /= ncol[d], d++) c[d] = q % ncol[d];
+			for (int p = 0; p < ncomp; p++)
+			{
+				xc.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+				for (MFIter mfi(xc, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+				{
+					const Box& bx = mfi.growntilebox();
+					amrex::Array4<amrex::Real> const& xarr = xc.array(mfi);
+					amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						amrex::IntVect m(AMREX_D_DECL(i,j,k));
+						for (int d = 0; d < AMREX_SPACEDIM; d++)
+							if (GalerkinColor(m[d],lo[d],len[d],per[d]) != c[d]) return;
+						xarr(i,j,k,p) = 1.0;
+					});
+				}
+
+				xf.setVal(0.0);
+				interpolation(amrlev,mglev-1,xf,xc);       // xf = P xc
+				Axf.setVal(0.0);
+				Fapply(amrlev,mglev-1,Axf,xf);             // Axf = A_f P xc
+				MultiFab::Subtract(Axf,A0f,0,0,ncomp,nghost);
+				Rx.setVal(0.0);
+				restriction(amrlev,mglev,Rx,Axf);          // Rx = R A_f P xc
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+				for (MFIter mfi(*stencil, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+				{
+					const Box bx = mfi.tilebox() & cdomain;
+					amrex::Array4<const amrex::Real> const& Rxarr = Rx.array(mfi);
+					amrex::Array4<amrex::Real> const& sarr = stencil->array(mfi);
+					amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						amrex::IntVect m(AMREX_D_DECL(i,j,k));
+						// The probe seen by this node is the neighbor with color c
+						int o = 0, stride = 1;
+						for (int d = 0; d < AMREX_SPACEDIM; d++)
+						{
+							int r = -2;
+							for (int t = -1; t <= 1; t++)
+								if (GalerkinColor(m[d]+t,lo[d],len[d],per[d]) == c[d]) r = t;
+							if (r == -2) return;
+							o += (r + 1)*stride;
+							stride *= 3;
+						}
+						for (int n = 0; n < ncomp; n++)
+							sarr(i,j,k,(n*ncomp + p)*nsten + o) = Rxarr(i,j,k,n);
+					});
+				}
+			}
+		}
+
+		stencil->FillBoundary(m_geom[amrlev][mglev].periodicity());
+		m_galerkin_stencil[mglev] = std::move(stencil);
+	}
+	ForgetGhosts();
+
+	// The whole hierarchy is built in double precision; only then are the
+	// stencils demoted, so that errors do not compound from level to level.
+	if (m_mixed_precision)
+	{
+		m_galerkin_stencil_sp.resize(m_num_mg_levels[amrlev]);
+		for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; mglev++)
+		{
+			const MultiFab &stencil = *m_galerkin_stencil[mglev];
+			m_galerkin_stencil_sp[mglev].reset(new amrex::FabArray<amrex::BaseFab<float> >(stencil.boxArray(), stencil.DistributionMap(),
+													stencil.nComp(), stencil.nGrow()));
+			ToSinglePrecision(*m_galerkin_stencil_sp[mglev], stencil);
+			m_galerkin_stencil[mglev].reset();
+		}
+	}
+}
+
+/// Apply a stored 3^d-point nodal stencil (double or single precision coefficients)
+template<class FAB>
+static void ApplyStencil (const amrex::FabArray<FAB> &stencil, const amrex::Box &domain, const int ncomp,
+			  MultiFab& out, const MultiFab& in)
+{
+	const int nsten = AMREX_D_TERM(3,*3,*3);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+	for (MFIter mfi(out, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		const Box bx = mfi.growntilebox(1) & domain;
+		const auto sarr = stencil.const_array(mfi);
+		amrex::Array4<const amrex::Real> const& inarr = in.array(mfi);
+		amrex::Array4<amrex::Real> const& outarr = out.array(mfi);
+		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+			amrex::IntVect m(AMREX_D_DECL(i,j,k));
+			for (int n = 0; n < ncomp; n++)
+			{
+				Set::Scalar f = 0.0;
+				for (int o = 0; o < nsten; o++)
+				{
+					amrex::IntVect s = m;
+					for (int d = 0, q = o; d < AMREX_SPACEDIM; d++, q /= 3) s[d] += q % 3 - 1;
+					if (!domain.contains(s)) continue;
+					for (int p = 0; p < ncomp; p++)
+						f += (Set::Scalar)sarr(m,(n*ncomp + p)*nsten + o) * inarr(s,p);
+				}
+				outarr(i,j,k,n) = f;
+			}
+		});
+	}
+}
+
+/// Extract the diagonal of a stored 3^d-point nodal stencil
+template<class FAB>
+static void StencilDiagonal (const amrex::FabArray<FAB> &stencil, const amrex::Box &domain, const int ncomp, MultiFab& diag)
+{
+	const int nsten = AMREX_D_TERM(3,*3,*3);
+	const int center = (nsten - 1)/2;
+	diag.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+	for (MFIter mfi(diag, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		const Box bx = mfi.growntilebox(1) & domain;
+		const auto sarr = stencil.const_array(mfi);
+		amrex::Array4<amrex::Real> const& diagarr = diag.array(mfi);
+		amrex::ParallelFor (bx, ncomp, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) {
+			diagarr(i,j,k,n) = (Set::Scalar)sarr(i,j,k,(n*ncomp + n)*nsten + center);
+		});
+	}
+}
+
+bool
+Operator<Grid::Node>::GalerkinApply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) const
+{
+	if (amrlev != 0) return false;
+	// Periodic ghost nodes hold the images of their neighbors across the seam
+	const amrex::Box domain = StencilDomain(amrlev,mglev);
+
+	if (mglev < (int)m_galerkin_stencil_sp.size() && m_galerkin_stencil_sp[mglev])
+	{
+		BL_PROFILE("Operator::GalerkinApply()");
+		ApplyStencil(*m_galerkin_stencil_sp[mglev], domain, getNComp(), out, in);
+		return true;
+	}
+	if (mglev < (int)m_galerkin_stencil.size() && m_galerkin_stencil[mglev])
+	{
+		BL_PROFILE("Operator::GalerkinApply()");
+		ApplyStencil(*m_galerkin_stencil[mglev], domain, getNComp(), out, in);
+		return true;
+	}
+	return false;
+}
+
+bool
+Operator<Grid::Node>::GalerkinDiagonal (int amrlev, int mglev, MultiFab& diag) const
+{
+	if (amrlev != 0) return false;
+	// Periodic ghost nodes hold the images of their neighbors across the seam
+	const amrex::Box domain = StencilDomain(amrlev,mglev);
+
+	if (mglev < (int)m_galerkin_stencil_sp.size() && m_galerkin_stencil_sp[mglev])
+	{
+		StencilDiagonal(*m_galerkin_stencil_sp[mglev], domain, getNComp(), diag);
+		return true;
+	}
+	if (mglev < (int)m_galerkin_stencil.size() && m_galerkin_stencil[mglev])
+	{
+		StencilDiagonal(*m_galerkin_stencil[mglev], domain, getNComp(), diag);
+		return true;
+	}
+	return false;
+}
+
+struct Operator<Grid::Node>::BottomLU
+{
+	amrex::Box domain; // nodal domain of the bottom level
+	int ncomp = 0;
+	int root = 0;      // the rank that holds the factorization
+	Eigen::SparseLU<Eigen::SparseMatrix<Set::Scalar>, Eigen::COLAMDOrdering<int> > lu;
+};
+
+void
+Operator<Grid::Node>::FactorBottom ()
+{
+	BL_PROFILE("Operator::FactorBottom()");
+
+	const int mglev = m_num_mg_levels[0] - 1;
+	const Geometry &geom = m_geom[0][mglev];
+	if (geom.isAnyPeriodic()) Util::Abort(INFO,"The direct bottom solve does not support periodic domains");
+
+	amrex::Box domain(geom.Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+
+	const int ncomp = getNComp();
+	const int w = DiagonalStencilWidth();
+	const int sep = 2*w + 1;
+	const int nsten = AMREX_D_TERM(sep,*sep,*sep);
+	const int ncoef = ncomp*ncomp*nsten;
+
+	const BoxArray &ba = m_diag[0][mglev]->boxArray();
+	const DistributionMapping &dm = m_diag[0][mglev]->DistributionMap();
+	MultiFab x(ba, dm, ncomp, getNGrow()), Ax(ba, dm, ncomp, getNGrow()), A0(ba, dm, ncomp, getNGrow());
+	MultiFab coef(ba, dm, ncoef, 0);
+	coef.setVal(0.0);
+
+	// Any affine part of Fapply (e.g. boundary values) is subtracted from every probe
+	x.setVal(0.0);
+	A0.setVal(0.0);
+	Fapply(0,mglev,A0,x);
+
+	// Nodes of the same color are 2w+1 apart, so a node sees at most one probed
+	// node within its stencil, and one Fapply per (color, component) yields
+	// whole columns of the matrix. Coefficient (n*ncomp + p)*nsten + o of node m
+	// couples component n of m to component p of the node at offset o.
+	for (int color = 0; color < nsten; color++)
+	{
+		const amrex::IntVect c(AMREX_D_DECL(color % sep, (color / sep) % sep, color / (sep*sep)));
+		for (int p = 0; p < ncomp; p++)
+		{
+			x.setVal(0.0);
+			Ax.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+			for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				const Box& bx = mfi.growntilebox();
+				amrex::Array4<amrex::Real> const& xarr = x.array(mfi);
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					amrex::IntVect m(AMREX_D_DECL(i,j,k));
+					for (int d = 0; d < AMREX_SPACEDIM; d++)
+						if (((m[d] % sep) + sep) % sep != c[d]) return;
+					xarr(i,j,k,p) = 1.0;
+				});
+			}
+
+			Fapply(0,mglev,Ax,x);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+			for (MFIter mfi(coef, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				const Box bx = mfi.tilebox() & domain;
+				amrex::Array4<const amrex::Real> const& Axarr = Ax.array(mfi);
+				amrex::Array4<const amrex::Real> const& A0arr = A0.array(mfi);
+				amrex::Array4<amrex::Real> const& coefarr = coef.array(mfi);
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					amrex::IntVect m(AMREX_D_DECL(i,j,k));
+					int o = 0, stride = 1;
+					for (int d = 0; d < AMREX_SPACEDIM; d++)
+					{
+						int r = (((c[d] - m[d]) % sep) + sep) % sep;
+						if (r > w) r -= sep;
+						o += (r + w)*stride;
+						stride *= sep;
+					}
+					for (int n = 0; n < ncomp; n++)
+						coefarr(i,j,k,(n*ncomp + p)*nsten + o) = Axarr(i,j,k,n) - A0arr(i,j,k,n);
+				});
+			}
+		}
+	}
+
+	// Gather the whole level onto one rank and factor it there
+	m_bottom_lu = std::make_shared<BottomLU>();
+	BottomLU &bottom = *m_bottom_lu;
+	bottom.domain = domain;
+	bottom.ncomp = ncomp;
+	bottom.root = amrex::ParallelDescriptor::IOProcessorNumber();
+
+	MultiFab rootcoef(BoxArray(domain), DistributionMapping(amrex::Vector<int>{bottom.root}), ncoef, 0);
+	rootcoef.ParallelCopy(coef, 0, 0, ncoef);
+
+	const int nrows = domain.numPts()*ncomp;
+	if (nrows > 1000000) Util::Warning(INFO,"Factoring a bottom level with ",nrows," unknowns; consider more coarsening");
+
+	for (MFIter mfi(rootcoef); mfi.isValid(); ++mfi) // only on the root rank
+	{
+		amrex::Array4<const amrex::Real> const& a = rootcoef.const_array(mfi);
+		std::vector<Eigen::Triplet<Set::Scalar> > entries;
+		for (amrex::IntVect m = domain.smallEnd(); m <= domain.bigEnd(); domain.next(m))
+			for (int n = 0; n < ncomp; n++)
+				for (int p = 0; p < ncomp; p++)
+					for (int o = 0; o < nsten; o++)
+					{
+						const Set::Scalar v = a(m,(n*ncomp + p)*nsten + o);
+						if (v == 0.0) continue;
+						amrex::IntVect s = m;
+						for (int d = 0, q = o; d < AMREX_SPACEDIM; d++, q /= sep) s[d] += q % sep - w;
+						if (!domain.contains(s)) continue;
+						entries.push_back(Eigen::Triplet<Set::Scalar>((int)domain.index(m)*ncomp + n,
+											       (int)domain.index(s)*ncomp + p, v));
+					}
+
+		Eigen::SparseMatrix<Set::Scalar> A(nrows,nrows);
+		A.setFromTriplets(entries.begin(), entries.end());
+		bottom.lu.compute(A);
+		if (bottom.lu.info() != Eigen::Success)
+			Util::Abort(INFO,"Could not factor the bottom operator (is it singular?): ",bottom.lu.lastErrorMessage());
+	}
+
+	m_bottom_factored = true;
+}
+
+void
+Operator<Grid::Node>::DirectBottomSolve (MultiFab& x, const MultiFab& b) const
+{
+	BL_PROFILE("Operator::DirectBottomSolve()");
+	if (!m_bottom_factored) Util::Abort(INFO,"Direct bottom solve used before the bottom operator was factored");
+
+	const BottomLU &bottom = *m_bottom_lu;
+	const amrex::Box &domain = bottom.domain;
+	const int ncomp = bottom.ncomp;
+
+	BoxArray rootba(domain);
+	DistributionMapping rootdm(amrex::Vector<int>{bottom.root});
+	MultiFab rootb(rootba, rootdm, ncomp, 0), rootx(rootba, rootdm, ncomp, 0);
+	rootb.ParallelCopy(b, 0, 0, ncomp);
+
+	for (MFIter mfi(rootb); mfi.isValid(); ++mfi) // only on the root rank
+	{
+		amrex::Array4<const amrex::Real> const& barr = rootb.const_array(mfi);
+		amrex::Array4<amrex::Real> const& xarr = rootx.array(mfi);
+
+		Eigen::Matrix<Set::Scalar,Eigen::Dynamic,1> rhs(domain.numPts()*ncomp);
+		for (amrex::IntVect m = domain.smallEnd(); m <= domain.bigEnd(); domain.next(m))
+			for (int n = 0; n < ncomp; n++) rhs((int)domain.index(m)*ncomp + n) = barr(m,n);
+
+		Eigen::Matrix<Set::Scalar,Eigen::Dynamic,1> sol = bottom.lu.solve(rhs);
+
+		for (amrex::IntVect m = domain.smallEnd(); m <= domain.bigEnd(); domain.next(m))
+			for (int n = 0; n < ncomp; n++) xarr(m,n) = sol((int)domain.index(m)*ncomp + n);
+	}
+
+	x.setVal(0.0);
+	x.ParallelCopy(rootx, 0, 0, ncomp);
+	FillGhosts(x,m_geom[0][m_num_mg_levels[0]-1]);
 }
 
 
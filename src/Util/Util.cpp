@@ -1,4 +1,5 @@
 #include "Util.H"
+#include "Random.H"
 #include "Color.H"
 
 #include "AMReX_ParallelDescriptor.H"
@@ -78,10 +79,15 @@ void Initialize ()
 	char **argv = nullptr;
 	Initialize(argc,argv);
 }
-void Initialize (int argc, char* argv[])
+std::uint64_t random_seed = 0;
+
+std::uint64_t RandomSeed()
 {
-	srand (time(NULL));
+	return random_seed;
+}
 
+void Initialize (int argc, char* argv[])
+{
 	// if (argc < 2)
 	// {
 	// 	std::cout << "No plot file specified!" << std::endl;
@@ -94,6 +100,22 @@ void Initialize (int argc, char* argv[])
 	pp_amrex.add("throw_exception",1);
 	//amrex.throw_exception=1
 
+	// Every rank uses the same seed, so that both Util::Random() and the
+	// counter-based generator produce the same numbers everywhere.
+	// A negative seed selects a time-based seed, chosen on the IO processor.
+	{
+		amrex::ParmParse pp_random("random");
+		long seed = 2;
+		pp_random.query("seed",seed);
+		if (seed < 0)
+		{
+			seed = (long)time(NULL);
+			amrex::ParallelDescriptor::Bcast(&seed,1,amrex::ParallelDescriptor::IOProcessorNumber());
+		}
+		random_seed = (std::uint64_t)seed;
+		srand((unsigned int)seed);
+	}
+
 	signal(SIGSEGV, Util::SignalHandler);
 	signal(SIGINT,  Util::SignalHandler);
 	signal(SIGABRT, Util::SignalHandler);
@@ -15,6 +15,7 @@
 #include "Integrator/PolymerDegradation.H"
 #include "Integrator/HeatConduction.H"
 #include "Integrator/Fracture.H"
+#include "Integrator/Homogenization.H"
 
 int main (int argc, char* argv[])
 {
@@ -26,7 +27,6 @@ int main (int argc, char* argv[])
 
 	if (program == "microstructure")
 	{
-		srand(2);
 		Integrator::Integrator *pfm = new Integrator::PhaseFieldMicrostructure();
 		//Integrator::PhaseFieldMicrostructure pfm;
 		pfm->InitData();
@@ -63,7 +63,6 @@ int main (int argc, char* argv[])
 	}
 	else if (program == "degradation")
 	{
-		srand(1.0*amrex::ParallelDescriptor::MyProc());
 		Integrator::PolymerDegradation model;
 		model.InitData();
 		model.Evolve();
@@ -71,12 +70,18 @@ int main (int argc, char* argv[])
 	}
 	else if (program == "fracture")
 	{
-		srand(1.0*amrex::ParallelDescriptor::MyProc());
 		Integrator::Fracture model;
 		model.InitData();
 		model.Evolve();
 		//delete model;
 	}
+	else if (program == "homogenization")
+	{
+		Integrator::Integrator *homogenization = new Integrator::Homogenization();
+		homogenization->InitData();
+		homogenization->Evolve();
+		delete homogenization;
+	}
 	else if (program == "trigtest")
 	{
 		Test::Operator::Elastic test;
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+#
+# Compare effective_modulus.dat from tests/HomogenizationLaminate with the
+# exact effective modulus of a laminate of two isotropic phases with equal
+# volume fractions and layer normal x. Exits with status 1 on a mismatch.
+#
+
+import argparse
+import sys
+
+parser = argparse.ArgumentParser()
+parser.add_argument('output', help='plot file directory of the run')
+parser.add_argument('--tol', type=float, default=0.03, help='allowed relative error per component')
+args = parser.parse_args()
+
+# (C11, C12, C44) of model1 and model2, as in tests/HomogenizationLaminate/input
+phases = [(2.0, 1.0, 0.5), (20.0, 10.0, 5.0)]
+def avg(f): return sum(f(*p) for p in phases) / len(phases)
+
+# Continuity of traction across the layers and of in-plane strain gives
+#   C1111 = <1/C11>^-1,   C1212 = C1313 = <1/C44>^-1,   C2323 = <C44>
+#   C1122 = <C12/C11> / <1/C11>
+#   C2222 = <C11 - C12^2/C11> + <C12/C11>^2 / <1/C11>
+#   C2233 = <C12 - C12^2/C11> + <C12/C11>^2 / <1/C11>
+inv11 = avg(lambda c11, c12, c44: 1.0/c11)
+r = avg(lambda c11, c12, c44: c12/c11)
+C1111 = 1.0/inv11
+C1122 = r/inv11
+C2222 = avg(lambda c11, c12, c44: c11 - c12*c12/c11) + r*r/inv11
+C2233 = avg(lambda c11, c12, c44: c12 - c12*c12/c11) + r*r/inv11
+C2323 = avg(lambda c11, c12, c44: c44)
+C1212 = 1.0/avg(lambda c11, c12, c44: 1.0/c44)
+
+# Voigt order 11, 22, 33, 23, 13, 12
+exact = [[C1111, C1122, C1122, 0,     0,     0    ],
+         [C1122, C2222, C2233, 0,     0,     0    ],
+         [C1122, C2233, C2222, 0,     0,     0    ],
+         [0,     0,     0,     C2323, 0,     0    ],
+         [0,     0,     0,     0,     C1212, 0    ],
+         [0,     0,     0,     0,     0,     C1212]]
+
+computed = [[float(v) for v in line.split()] for line in open(args.output + '/effective_modulus.dat') if line.strip()]
+if len(computed) != 6 or any(len(row) != 6 for row in computed):
+    print("Expected a 6x6 modulus in effective_modulus.dat")
+    sys.exit(1)
+
+failed = False
+scale = max(abs(v) for row in exact for v in row)
+for I in range(6):
+    for J in range(6):
+        ref = exact[I][J]
+        err = abs(computed[I][J] - ref) / (abs(ref) if ref != 0 else scale)
+        if err > args.tol:
+            print("C{}{}: computed {:.6g}, exact {:.6g} (relative error {:.3g})".format(I+1, J+1, computed[I][J], ref, err))
+            failed = True
+
+print("Laminate check " + ("FAILED" if failed else "passed"))
+sys.exit(1 if failed else 0)